@@ -6,13 +6,39 @@
 #include <string.h>
 #include <time.h>
 #include <limits.h>
+#include <pthread.h>
 
 // Constants
-#define BOARD_SIZE 3
-#define MAX_MAZE_SIZE 20
-#define MAX_QUEUE_SIZE 1000
-#define MAX_STACK_SIZE 1000
-#define MEMO_TABLE_SIZE 1000
+#define MAX_BOARD_SIZE 15
+#define MAX_BOARD_CELLS (MAX_BOARD_SIZE * MAX_BOARD_SIZE)
+#define MAX_WIN_LINES (4 * MAX_BOARD_CELLS)
+#define DEFAULT_MOVE_TIME_MS 1000
+#define WIN_SCORE 30000
+#define MAX_SEARCH_PLY (MAX_BOARD_CELLS + 1)
+#define ASPIRATION_WINDOW 64
+#define MAX_SEARCH_THREADS 64
+#define MAX_SELF_PLAY_THREADS 64
+#define MCTS_POOL_NODES (1 << 20)      // most nodes one search tree may hold
+#define MCTS_EXPLORATION 1.4
+#define MCTS_EASY_ITERATIONS 24
+#define MCTS_MEDIUM_ITERATIONS 400
+#define MAX_MAZE_SIZE 50000            // cells per side; every cell index fits in 32 bits
+#define MAZE_PRINT_LIMIT 100            // most characters a side printMaze draws; larger mazes are downsampled
+#define MAZE_NO_CELL 0xFFFFFFFFu
+#define MAX_MAZE_THREADS 64
+#define MAZE_MAX_WEIGHT 9               // terrain costs are 1 to this, one digit in text mazes
+#define MAZE_CACHED_FIELDS 8            // distance fields a MazeEngine keeps between batches
+#define MAZE_HOT_SOURCE_QUERIES 4       // searches sharing an endpoint before it gets a field
+#define MAZE_SENSOR_RANGE 8             // replanning demo: how far from the agent cells change
+#define MAZE_CLUSTER_SIZE 32            // cells per side of a hierarchy cluster
+#define MAZE_CLUSTER_NODES (2 * MAZE_CLUSTER_SIZE + 4)   // entrances one cluster can have
+#define MAZE_ENTRANCE_SPLIT 6           // border openings this wide get an entrance at each end
+#define MAZE_FRAME_MILLIS 20            // pause between frames of a search animation
+#define TT_SIZE_LOG2 16
+#define TT_BUCKET_SIZE 4
+#define PERFECT_TABLE_FILE "ttt_perfect_3x3.bin"
+#define PERFECT_TABLE_STATES 19683     // 3^9 square assignments
+#define SEARCH_STATS_FILE "ttt_search_stats.jsonl"
 
 // Common structures
 typedef struct {
@@ -23,46 +49,550 @@ typedef struct {
     int x, y;
 } MazePoint;
 
+// xoshiro256** generator state. Not thread-safe: give each thread its own.
+typedef struct {
+    unsigned long long s[4];
+} Rng;
+
 // Tic-Tac-Toe structures
-typedef struct MemoEntry {
-    char key[BOARD_SIZE * BOARD_SIZE + 1];
-    int score;
-    int move_i, move_j;
-    struct MemoEntry* next;
-} MemoEntry;
+typedef struct {
+    int size;                   // board is size x size
+    int winLength;              // stones in a row needed to win
+    int moveTimeMs;             // wall-clock budget per AI move
+    int maxDepth;               // iterative deepening cap in plies, 0 = none
+    int threads;                // search threads, 1 = serial
+    int parallelMode;           // PARALLEL_ROOT_SPLIT or PARALLEL_LAZY_SMP
+    int verbose;                // print a search report for every AI move
+    int searchEngine;           // SEARCH_ALPHA_BETA or SEARCH_MCTS, used by Hard
+} TicTacToeConfig;
+
+// Parallel search modes
+#define PARALLEL_ROOT_SPLIT 1   // root moves handed out to threads each iteration
+#define PARALLEL_LAZY_SMP 2     // helper threads run their own deepening loop
+
+// Search engines
+#define SEARCH_ALPHA_BETA 1     // iterative deepening minimax
+#define SEARCH_MCTS 2           // Monte Carlo tree search with random playouts
+
+// Positions are bitboards: bit (row * size + col) is set in x or o when
+// that side holds the square. Wide enough for MAX_BOARD_SIZE.
+#define BOARD_WORDS ((MAX_BOARD_CELLS + 63) / 64)
+
+typedef struct {
+    unsigned long long w[BOARD_WORDS];
+} BoardMask;
+
+#define NUM_SYMMETRIES 8
+
+// keys[s] hashes the position as seen through dihedral symmetry s
+// (keys[0] is the identity), so every rotation and reflection of a
+// position shares the same smallest key.
+typedef struct {
+    BoardMask x;                // squares held by X (AI)
+    BoardMask o;                // squares held by O (human)
+    unsigned long long keys[NUM_SYMMETRIES];
+} Bitboard;
+
+// Transposition table bound flags
+#define TT_NONE 0
+#define TT_EXACT 1
+#define TT_LOWER 2
+#define TT_UPPER 3
+
+// ttProbe() results
+#define TT_MISS 0
+#define TT_HIT 1
+#define TT_COLLISION 2          // miss, and every slot in the bucket holds another position
+
+// Unpacked view of one table slot.
+typedef struct {
+    int score;                  // distance-to-end adjusted, see scoreToTT()
+    int bestMove;               // cell index in the canonical frame, -1 if none
+    int depth;                  // remaining plies the score was searched to
+    int flag;                   // TT_NONE, TT_EXACT, TT_LOWER or TT_UPPER
+    int age;                    // search generation that wrote the entry
+} TTEntry;
+
+// Slots are shared by search threads without locks: data packs a TTEntry
+// into 64 bits and check holds key ^ data, so a slot torn by two
+// concurrent writers fails verification instead of returning bad data.
+typedef struct {
+    unsigned long long check;
+    unsigned long long data;
+} TTSlot;
+
+typedef struct {
+    TTSlot* slots;
+    unsigned int size;          // power of two
+    unsigned int mask;
+    int count;                  // occupied slots, updated atomically
+    unsigned char age;
+} TranspositionTable;
+
+// Counters for one AI move, summed over its threads. Alpha-beta fills all
+// of them; MCTS fills the playout count, tree depth and time.
+typedef struct {
+    int engine;                 // SEARCH_ALPHA_BETA, SEARCH_MCTS, 0 for a table or forced move
+    int threads;
+    int depth;                  // deepest completed iteration, or deepest MCTS tree path
+    long long nodes;            // minimax calls, or MCTS playouts
+    long long nodesAtPly[MAX_SEARCH_PLY];  // [p] counts positions p + 1 plies below the root
+    long long ttProbes, ttHits, ttCollisions;
+    long long cutoffs;          // beta cutoffs
+    long long firstMoveCutoffs; // cutoffs caused by the first move tried
+    long long expandedNodes;    // positions whose moves were searched
+    long long movesSearched;    // moves tried at those positions
+    long long elapsedNanos;     // monotonic wall-clock time
+} SearchStats;
+
+// Per-search state threaded through minimax.
+typedef struct {
+    TranspositionTable* tt;
+    long long deadline;         // monotonicNanos() value at which to stop
+    int stopped;                // set once the deadline passes
+    int* sharedStop;            // set by the main thread to end helpers, or NULL
+    short killers[MAX_SEARCH_PLY][2];   // quiet moves that caused cutoffs, per ply
+    int history[2][MAX_BOARD_CELLS];    // cutoff credit per side and square
+    SearchStats stats;          // this thread's counters
+} SearchContext;
+
+// Monte Carlo tree node. A node's children form a list through
+// nextSibling and are created one per visit, in move-list order.
+typedef struct {
+    int firstChild;             // most recently created child, -1 if none
+    int nextSibling;            // -1 at the end of the list
+    int move;                   // cell played to reach this node
+    int expanded;               // children created so far
+    int visits;                 // finished playouts plus virtual losses in flight
+    int score;                  // 2 per win and 1 per draw for the side that moved here
+} MctsNode;
+
+// Nodes come from one pool and are never freed individually: the tree is
+// kept between moves while the game follows it and the pool has room,
+// and is otherwise started again. Zero-initialised means empty.
+typedef struct {
+    MctsNode* nodes;
+    int capacity;
+    int used;                   // claimed atomically by search threads
+    int root;                   // valid while used > 0
+    Bitboard rootBoard;         // position at the root, X to move
+} MctsTree;
+
+// One solved position. value is X's score with perfect play from here:
+// 10 - plies to an X win, plies - 10 to an O win, 0 for a draw.
+typedef struct {
+    signed char value;
+    signed char bestMove;       // cell for the side to move, -1 if terminal or unreachable
+} PerfectEntry;
+
+// On-disk layout: header, then PerfectEntry[PERFECT_TABLE_STATES * 2]
+// indexed by base-3 position * 2 + (O to move).
+typedef struct {
+    char magic[8];
+    int boardSize;
+    int states;
+    unsigned int checksum;      // FNV-1a over the entries
+} PerfectTableHeader;
+
+// Self-play levels: 1-3 are the game's difficulties, SELF_PLAY_RANDOM
+// picks uniformly among the empty squares.
+#define SELF_PLAY_RANDOM 0
+
+typedef struct {
+    long long games;            // games to play; starts alternate X, O, X, ...
+    int threads;                // worker threads, each playing its own games
+    int xLevel, oLevel;         // SELF_PLAY_RANDOM or a difficulty 1-3
+    unsigned long long seed;    // random choices depend only on seed and game number
+} SelfPlayConfig;
 
 typedef struct {
-    MemoEntry** table;
-    int size;
-    int count;
-} MemoTable;
+    long long games;
+    long long xWins, oWins, draws;
+    long long moves;
+    long long nodes;            // search nodes over all AI moves
+    double seconds;
+} SelfPlayResult;
 
 // Maze structures
+// Cells are bits in a padded row-major grid: each row is stride bits (a
+// multiple of 64) and a ring of wall cells surrounds the maze, so every
+// open cell has four in-range neighbours and no bounds checks are needed.
+// Cell (x, y) is bit (x + 1) * stride + (y + 1); the solvers refer to
+// cells by that 32-bit index.
+typedef struct {
+    unsigned long long* open;   // 1 = open, 0 = wall; padding is wall
+    int width, height;
+    unsigned int stride;        // bits per padded row
+    MazePoint start, end;
+    unsigned char* weight;      // per padded cell: cost of stepping onto it; NULL if every step costs 1
+    size_t mappedBytes;         // length of the maze file mapping open points into, 0 if allocated
+} Maze;
+
+// Maze generators. Noise mazes are walls scattered at a given density and
+// may have no path; the others are perfect mazes, with exactly one path
+// between any two open cells.
+#define MAZE_GEN_NOISE 0
+#define MAZE_GEN_BACKTRACKER 1
+#define MAZE_GEN_KRUSKAL 2
+#define MAZE_GEN_PRIM 3
+#define MAZE_GEN_WILSON 4
+
+// Maze file layout: header, then the open bitset exactly as it sits in
+// memory (mazeWords words, padding included), then for a weighted maze one
+// weight byte per padded cell, so a mapped file is used in place. The
+// header is a multiple of 8 bytes to keep the words aligned.
+typedef struct {
+    char magic[8];
+    int width, height;
+    MazePoint start, end;
+    unsigned int stride;
+    unsigned int weighted;      // 1 if the weights follow the bitset
+} MazeFileHeader;
+
+// Scratch for one search: a cell's bit in unvisited is cleared when it is
+// reached, and parentDir then holds (2 bits) the direction it was
+// entered from, so the parent is cell - mazeStep(maze, direction).
 typedef struct {
-    MazePoint points[MAX_QUEUE_SIZE];
-    int front, rear;
+    unsigned long long* unvisited;
+    unsigned long long* parentDir;
+} MazeSearch;
+
+// Frontiers grow on demand. A solver adds each cell at most once, so they
+// never hold more than width * height entries.
+typedef struct {
+    unsigned int* cells;
+    size_t head, tail, capacity;
 } MazeQueue;
 
 typedef struct {
-    MazePoint points[MAX_STACK_SIZE];
-    int top;
+    unsigned int* cells;
+    size_t top, capacity;
 } MazeStack;
 
+// Indexed binary min-heap of cells, so a queued cell's key can be found
+// and changed.
+typedef struct {
+    unsigned int* cells;
+    unsigned long long* keys;
+    size_t size, capacity;
+    unsigned int* slot;         // per cell: heap position + 1, 0 if not queued
+} MazeHeap;
+
+// Maze grid helpers. Directions: 0 east, 1 south, 2 west, 3 north.
+static inline unsigned int mazeIndex(const Maze* maze, int x, int y) {
+    return (unsigned int)(x + 1) * maze->stride + (unsigned int)(y + 1);
+}
+
+static inline MazePoint mazePointOf(const Maze* maze, unsigned int cell) {
+    MazePoint p = {(int)(cell / maze->stride) - 1, (int)(cell % maze->stride) - 1};
+    return p;
+}
+
+static inline int mazeStep(const Maze* maze, int direction) {
+    int stride = (int)maze->stride;
+    int steps[4] = {1, stride, -1, -stride};
+    return steps[direction];
+}
+
+static inline size_t mazeWords(const Maze* maze) {
+    return (size_t)(maze->height + 2) * maze->stride / 64;
+}
+
+static inline unsigned int mazeManhattan(const Maze* maze, unsigned int a, unsigned int b) {
+    int dx = (int)(a / maze->stride) - (int)(b / maze->stride);
+    int dy = (int)(a % maze->stride) - (int)(b % maze->stride);
+    return (unsigned int)((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy));
+}
+
+static inline unsigned int mazeWeight(const Maze* maze, unsigned int cell) {
+    return maze->weight ? maze->weight[cell] : 1;
+}
+
+static inline int testMazeBit(const unsigned long long* bits, unsigned int cell) {
+    return (int)((bits[cell >> 6] >> (cell & 63)) & 1);
+}
+
+static inline void setMazeBit(unsigned long long* bits, unsigned int cell) {
+    bits[cell >> 6] |= 1ULL << (cell & 63);
+}
+
+static inline void clearMazeBit(unsigned long long* bits, unsigned int cell) {
+    bits[cell >> 6] &= ~(1ULL << (cell & 63));
+}
+
+// Marks cell visited, entered by a step in direction.
+static inline void reachMazeCell(MazeSearch* search, unsigned int cell, int direction) {
+    clearMazeBit(search->unvisited, cell);
+    search->parentDir[cell >> 5] |= (unsigned long long)direction << ((cell & 31) * 2);
+}
+
+static inline int parentDirection(const MazeSearch* search, unsigned int cell) {
+    return (int)((search->parentDir[cell >> 5] >> ((cell & 31) * 2)) & 3);
+}
+
+// For searches that may find a shorter way into a cell later.
+static inline void setParentDirection(MazeSearch* search, unsigned int cell, int direction) {
+    unsigned long long* word = &search->parentDir[cell >> 5];
+    int shift = (cell & 31) * 2;
+    *word = (*word & ~(3ULL << shift)) | (unsigned long long)direction << shift;
+}
+
+// Which of cell's four neighbours are set in bits, as a mask with bit d
+// for direction d. Reads the cell's word, at most one horizontally
+// adjacent word, and the words one row above and below.
+static inline int mazeNeighbours(const unsigned long long* bits, unsigned int cell, unsigned int stride) {
+    unsigned int word = cell >> 6, bit = cell & 63, rowWords = stride >> 6;
+    unsigned long long row = bits[word];
+    int east = (int)(bit < 63 ? (row >> (bit + 1)) & 1 : bits[word + 1] & 1);
+    int west = (int)(bit > 0 ? (row >> (bit - 1)) & 1 : bits[word - 1] >> 63);
+    int south = (int)((bits[word + rowWords] >> bit) & 1);
+    int north = (int)((bits[word - rowWords] >> bit) & 1);
+    return east | south << 1 | west << 2 | north << 3;
+}
+
+// Cell indices from start to end inclusive.
+typedef struct {
+    unsigned int* cells;
+    long long length;
+} MazePath;
+
+// Signature shared by the single-threaded solvers: fills path and returns
+// 1 if end is reachable from start.
+typedef int (*MazeSolver)(Maze* maze, MazePath* path, long long* nodesExplored);
+
+// One start-to-end query for a MazeEngine.
 typedef struct {
-    char maze[MAX_MAZE_SIZE][MAX_MAZE_SIZE];
-    int width, height;
     MazePoint start, end;
-} Maze;
+    long long distance;         // steps on a shortest path, -1 if unreachable
+} MazeQuery;
+
+// BFS distances from source to every padded cell, MAZE_NO_CELL where
+// unreachable. source is MAZE_NO_CELL while the slot is unused.
+typedef struct {
+    unsigned int source;
+    unsigned int* distance;
+    long long lastBatch;        // last batch that asked for this field
+} MazeDistanceField;
+
+// D* Lite state for replanning to a fixed end as walls change and the
+// start moves. The search runs backwards from the end: g is a cell's
+// cost to the end as last settled and rhs its one-step lookahead, and
+// only cells where the two differ are queued. Costs must stay below 2^32.
+typedef struct {
+    Maze maze;                  // own copy of the walls; the weights stay shared with the source maze
+    unsigned int* g;            // per padded cell, MAZE_NO_CELL while unknown
+    unsigned int* rhs;
+    MazeHeap heap;
+    unsigned int startCell, endCell;
+    unsigned int lastStart;     // start when keyModifier was last raised
+    unsigned int keyModifier;   // km: how far the start has moved in all
+    long long updates, expansions;   // totals over the planner's life
+} MazePlanner;
+
+// Cheapest way between two entrances of a cluster without leaving it;
+// it crosses at most every cell once, so its cost fits in 16 bits.
+typedef struct {
+    unsigned short cost;
+    unsigned short to;          // entrance it leads to
+} MazeClusterEdge;
+
+// One square of a MazeHierarchy. Its nodes are the entrance cells on its
+// borders, east, south, west then north, each border in order along it,
+// so entrance i of a border faces entrance i of the neighbour's opposite
+// border. Each node's edges lead to the other entrances it reaches inside
+// the cluster, except those it reaches as cheaply through a third.
+typedef struct {
+    int nodes;
+    int borderStart[5];         // border d holds nodes borderStart[d] to borderStart[d + 1] - 1
+    unsigned int cell[MAZE_CLUSTER_NODES];
+    int edgeStart[MAZE_CLUSTER_NODES + 1];   // node i's edges are edges[edgeStart[i]] to edges[edgeStart[i + 1] - 1]
+    MazeClusterEdge* edges;
+    unsigned int* stepStart;    // edge e's moves are steps stepStart[e] to stepStart[e + 1] - 1
+    unsigned char* steps;       // the moves of every edge, four 2-bit directions a byte
+} MazeCluster;
+
+// Search over one cluster, loaded into a local copy: row r + 1 of rows
+// has bit c + 1 set for each open cell, the rest are wall. Local cells
+// are numbered r * MAZE_CLUSTER_SIZE + c. Unweighted mazes use a plain
+// FIFO; weighted ones Dial's queue, each bucket a list threaded through a
+// fixed pool: a cell is queued once for the source and once per
+// improvement, through one of its four sides, so the pool never runs out
+// and a search never allocates.
+typedef struct {
+    unsigned long long rows[MAZE_CLUSTER_SIZE + 2];   // so clusters are at most 62 cells a side
+    unsigned char weight[MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE];
+    int weighted;
+    unsigned int dist[MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE];
+    unsigned char from[MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE];   // direction the cell was entered by
+    unsigned char goal[MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE];   // the search stops once these are settled
+    int head[MAZE_MAX_WEIGHT + 1];          // first entry of each bucket, -1 if empty
+    int entryCell[4 * MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE + 1];
+    int entryNext[4 * MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE + 1];
+} MazeClusterSearch;
+
+// A node of the entrance graph during a query.
+typedef struct {
+    unsigned int cost;          // g of the current query
+    unsigned int estimate;      // h: Manhattan distance to the query's end
+    unsigned int parent;
+    unsigned int stamp;         // query that last set the others
+} MazeHierarchyNode;
+
+// HPA*: the maze cut into clusters, with the cost and moves between every
+// two entrances of a cluster worked out in advance. Queries search the
+// graph of entrances and then lay out the moves of the edges they took.
+// Queries share scratch space, so one hierarchy answers one query at a
+// time.
+typedef struct {
+    Maze maze;                  // own copy of the walls; the weights stay shared with the source maze
+    int clusterRows, clusterColumns;
+    MazeCluster* clusters;
+    unsigned char* dirty;       // per cluster: cells changed since it was built
+    int dirtyCount;
+    MazeHierarchyNode* node;    // per graph node
+    unsigned int generation;
+    MazeHeap heap;
+    MazeClusterSearch* search;  // two: out from the start and in to the end of a query
+    long long rebuilt;          // clusters built, including the first time
+} MazeHierarchy;
+
+// Answers batches of queries against one maze, which must not change
+// while the engine is in use.
+typedef struct {
+    const Maze* maze;
+    unsigned int* component;    // per padded cell: component number from 1, 0 for walls
+    unsigned int components;
+    MazeDistanceField fields[MAZE_CACHED_FIELDS];
+    long long batches;
+    long long queries, rejected, fieldHits, searches, fieldsBuilt;   // totals over all batches
+} MazeEngine;
+
+// Draws a maze, or a window of it, into one buffer per frame. Each
+// character of the view stands for a scale x scale block of cells.
+typedef struct {
+    const Maze* maze;
+    unsigned long long* path;       // cells on the path, laid out like maze->open
+    unsigned long long* visited;    // cells marked by markMazeRendererCell
+    int top, left;                  // cell at the view's top-left corner
+    int rows, columns;              // view size in characters, borders excluded
+    int scale;
+    int maxRows, maxColumns;        // room the view may take up
+    unsigned char* shown;           // incremental mode: glyph last drawn at each character
+    char* buffer;                   // frame being built
+    size_t length, capacity;
+} MazeRenderer;
+
+// One piece of a file for writeFileAtomically.
+typedef struct {
+    const void* data;
+    size_t bytes;
+} FilePart;
 
 // Utility function declarations
 void clearInputBuffer();
 int getIntegerInput(const char* prompt, int min, int max);
 float getFloatInput(const char* prompt, float min, float max);
+long long monotonicNanos();
+int writeFileAtomically(const char* path, const FilePart parts[], int count);
+void getLineInput(const char* prompt, char* buffer, int size);
+void rngSeed(Rng* rng, unsigned long long seed);
+unsigned long long rngNext(Rng* rng);
+int rngBelow(Rng* rng, int bound);
 
 // Tic-Tac-Toe function declarations
+void initTicTacToeEngine();
+void configureTicTacToe(const TicTacToeConfig* config);
+void getTicTacToeConfig(TicTacToeConfig* config);
+int getCell(const Bitboard* board, int row, int col);
+void setCell(Bitboard* board, int row, int col, int player);
+void swapSides(Bitboard* board);
+int checkWinner(const Bitboard* board);
+void getAvailableMoves(const Bitboard* board, Point moves[], int* count);
+void freeTranspositionTable(TranspositionTable* tt);
+void freeMctsTree(MctsTree* tree);
+Point getAIMoveWithDifficulty(Bitboard* board, TranspositionTable* tt, MctsTree* mcts, SearchStats* stats, int difficulty, Rng* rng);
+double measureSearchSpeedup(const Bitboard* board, int threads, int mode, int depth);
+void addSearchStats(SearchStats* total, const SearchStats* move);
+void writeSearchStatsJson(FILE* out, const char* type, int index, const SearchStats* stats);
 void playTicTacToeWithLevels();
 
+// Self-play function declarations
+void runSelfPlay(const SelfPlayConfig* config, SelfPlayResult* result);
+void playSelfPlaySimulator();
+
 // Maze solver function declarations
+void initMaze(Maze* maze, int width, int height);
+void freeMaze(Maze* maze);
+void freeMazePath(MazePath* path);
+void initMazeSearch(MazeSearch* search, const Maze* maze);
+void freeMazeSearch(MazeSearch* search);
+void initMazeStack(MazeStack* s);
+void pushMaze(MazeStack* s, unsigned int cell);
+unsigned int popMaze(MazeStack* s);
+int isMazeStackEmpty(MazeStack* s);
+void freeMazeStack(MazeStack* s);
+void initMazeHeap(MazeHeap* heap, size_t cells);
+void freeMazeHeap(MazeHeap* heap);
+void pushMazeHeap(MazeHeap* heap, unsigned int cell, unsigned long long key);
+unsigned int popMazeHeap(MazeHeap* heap);
+void removeMazeHeap(MazeHeap* heap, unsigned int cell);
+void buildMazePath(const Maze* maze, const MazeSearch* search, unsigned int start, unsigned int end, MazePath* path);
+int bfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int dfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int bidirectionalSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int aStarSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int jpsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int dijkstraSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+int weightedAStarSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+long long mazePathCost(const Maze* maze, const MazePath* path);
+void addMazeTerrain(Maze* maze, int maxWeight, unsigned long long seed);
+int bitsetBfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored);
+long long bitsetBfsDistances(const Maze* maze, unsigned int source, unsigned int* distance);
+const char* bitsetBfsKernelName();
+int parallelBfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored, int threads);
+int mazeSolverCount();
+const char* mazeSolverName(int solver);
+int findMazeSolver(const char* name);
+int mazeSolverUsesHierarchy(int solver);
+int runMazeSolver(int solver, Maze* maze, MazeHierarchy* hierarchy, int threads, MazePath* path, long long* nodesExplored);
+void initMazePlanner(MazePlanner* planner, const Maze* maze);
+void freeMazePlanner(MazePlanner* planner);
+int replanMazePath(MazePlanner* planner, MazePath* path, long long* nodesExplored);
+int setMazePlannerCell(MazePlanner* planner, MazePoint point, int open);
+int moveMazePlannerStart(MazePlanner* planner, MazePoint point);
+void initMazeHierarchy(MazeHierarchy* hierarchy, const Maze* maze, int threads);
+void freeMazeHierarchy(MazeHierarchy* hierarchy);
+int setMazeHierarchyCell(MazeHierarchy* hierarchy, MazePoint point, int open);
+long long updateMazeHierarchy(MazeHierarchy* hierarchy, int threads);
+long long queryMazeHierarchy(MazeHierarchy* hierarchy, MazePoint start, MazePoint end, MazePath* path, long long* nodesExplored);
+void initMazeEngine(MazeEngine* engine, const Maze* maze);
+void freeMazeEngine(MazeEngine* engine);
+void answerMazeQueries(MazeEngine* engine, MazeQuery* queries, long long count, int threads);
+void generateMaze(Maze* maze, int width, int height, float wallDensity, unsigned long long seed);
+void generatePerfectMaze(Maze* maze, int width, int height, int generator, unsigned long long seed);
+void generateSeededMaze(Maze* maze, int width, int height, int generator, float wallDensity, int maxWeight,
+                        unsigned long long seed);
+int writeMazeFile(const Maze* maze, const char* path);
+int mapMazeFile(Maze* maze, const char* path);
+int readMazeText(Maze* maze, FILE* file);
+int loadMaze(Maze* maze, const char* path);
+void initMazeRenderer(MazeRenderer* renderer, const Maze* maze, int maxRows, int maxColumns);
+void freeMazeRenderer(MazeRenderer* renderer);
+void setMazeViewport(MazeRenderer* renderer, int top, int left, int scale);
+void setMazeRendererPath(MazeRenderer* renderer, const MazePath* path);
+void markMazeRendererCell(MazeRenderer* renderer, unsigned int cell);
+void renderMaze(MazeRenderer* renderer);
+void renderMazeChanges(MazeRenderer* renderer);
+void printMaze(const Maze* maze, const MazePath* path);
+int mazeAnimationAvailable();
+void animateMazeBfs(const Maze* maze, const MazePath* path);
+int inputMaze(Maze* maze, int weighted);
 void solveMaze(int algorithm);
+void playMazeQueryBatch();
+void playMazeReplanning();
+void playMazeHierarchy();
+
+// Command-line function declarations
+int runBatchCommand(int argc, char** argv);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "ai_agent.h"
+#include <errno.h>
+
+// Command-Line Batch Mode
+// Runs a solver or self-play from command-line options instead of the
+// menu, with no prompts, and prints one JSON line or CSV row per run so
+// scripts can drive and collect many runs. Run r of a generated maze uses
+// seed + r, so every record can be reproduced from its own fields.
+
+static const char* generatorNames[] = {"noise", "backtracker", "kruskal", "prim", "wilson"};
+
+// Every option but --help takes a value.
+static const char* batchOptionNames[] = {
+    "--maze", "--game", "--generator", "--width", "--height", "--density", "--weights", "--file", "--seed",
+    "--threads", "--repeat", "--format", "--board", "--win", "--x-level", "--o-level", "--games", "--move-ms", "--engine",
+};
+
+typedef struct {
+    int solver;                 // findMazeSolver index, or -1 to play Tic-Tac-Toe
+    int generator;
+    int width, height;
+    float density;
+    int maxWeight;
+    const char* file;
+    unsigned long long seed;
+    int threads;
+    int repeat;
+    int csv;
+    int boardSize, winLength;
+    int xLevel, oLevel;
+    long long games;
+    int moveTimeMs;
+    int searchEngine;
+} BatchOptions;
+
+static void printBatchUsage(FILE* out) {
+    fprintf(out,
+        "Usage: ai_agent [options]   (no options: interactive menu)\n"
+        "  --maze ALGORITHM    bfs, dfs, astar, jps, bidirectional, bitset, parallel,\n"
+        "                      dijkstra, weighted-astar or hpa\n"
+        "  --game tictactoe    self-play games instead of a maze\n"
+        "  --generator NAME    noise (default), backtracker, kruskal, prim or wilson\n"
+        "  --width N           maze width (default 101)\n"
+        "  --height N          maze height (default 101)\n"
+        "  --density F         wall density of noise mazes, 0.1-0.4 (default 0.25)\n"
+        "  --weights N         highest terrain cost, 1-%d (default 1)\n"
+        "  --file PATH         load the maze from a file instead\n"
+        "  --seed N            seed of the first run (default 1)\n"
+        "  --threads N         worker threads, 1-%d (default 1)\n"
+        "  --repeat N          runs (default 1)\n"
+        "  --format FORMAT     json (default) or csv\n"
+        "  --board N           Tic-Tac-Toe board size, 3-%d (default 3)\n"
+        "  --win N             stones in a row to win (default: board size, at most 5)\n"
+        "  --x-level N         X's level, 0 = random, 1-3 = easy to hard (default 3)\n"
+        "  --o-level N         O's level (default 0)\n"
+        "  --games N           games per run (default 100)\n"
+        "  --move-ms N         time per hard AI move on boards over 3x3 (default %d)\n"
+        "  --engine NAME       hard AI engine: alpha-beta (default) or mcts\n",
+        MAZE_MAX_WEIGHT, MAX_MAZE_THREADS, MAX_BOARD_SIZE, DEFAULT_MOVE_TIME_MS);
+}
+
+static int parseBatchInteger(const char* option, const char* text, long long min, long long max, long long* value) {
+    char* end;
+    long long parsed = strtoll(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || parsed < min || parsed > max) {
+        fprintf(stderr, "%s needs a whole number from %lld to %lld!\n", option, min, max);
+        return 0;
+    }
+    *value = parsed;
+    return 1;
+}
+
+// Seeds take the whole unsigned 64-bit range.
+static int parseBatchSeed(const char* text, unsigned long long* seed) {
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (*text < '0' || *text > '9' || *end != '\0' || errno == ERANGE) {
+        fprintf(stderr, "--seed needs a whole number from 0 to %llu!\n", ULLONG_MAX);
+        return 0;
+    }
+    *seed = parsed;
+    return 1;
+}
+
+static int parseBatchOptions(int argc, char** argv, BatchOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->solver = -1;
+    options->width = options->height = 101;
+    options->density = 0.25f;
+    options->maxWeight = 1;
+    options->seed = 1;
+    options->threads = 1;
+    options->repeat = 1;
+    options->boardSize = 3;
+    options->xLevel = 3;
+    options->oLevel = SELF_PLAY_RANDOM;
+    options->games = 100;
+    options->moveTimeMs = DEFAULT_MOVE_TIME_MS;
+    options->searchEngine = SEARCH_ALPHA_BETA;
+    int game = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (strcmp(option, "--help") == 0) {
+            printBatchUsage(stdout);
+            exit(0);
+        }
+        int known = 0;
+        for (size_t o = 0; o < sizeof(batchOptionNames) / sizeof(batchOptionNames[0]); o++) {
+            if (strcmp(option, batchOptionNames[o]) == 0) known = 1;
+        }
+        if (!known) {
+            fprintf(stderr, "Unknown option %s!\n", option);
+            return 0;
+        }
+        if (i + 1 == argc) {
+            fprintf(stderr, "%s needs a value!\n", option);
+            return 0;
+        }
+        const char* value = argv[++i];
+        long long number = 0;
+        int ok = 1;
+        if (strcmp(option, "--maze") == 0) {
+            options->solver = findMazeSolver(value);
+            if (options->solver < 0) {
+                fprintf(stderr, "Unknown maze algorithm %s!\n", value);
+                ok = 0;
+            }
+        } else if (strcmp(option, "--game") == 0) {
+            game = strcmp(value, "tictactoe") == 0;
+            if (!game) {
+                fprintf(stderr, "Unknown game %s!\n", value);
+                ok = 0;
+            }
+        } else if (strcmp(option, "--generator") == 0) {
+            options->generator = -1;
+            for (int g = 0; g < 5; g++) {
+                if (strcmp(value, generatorNames[g]) == 0) options->generator = g;
+            }
+            if (options->generator < 0) {
+                fprintf(stderr, "Unknown maze generator %s!\n", value);
+                ok = 0;
+            }
+        } else if (strcmp(option, "--width") == 0) {
+            if ((ok = parseBatchInteger(option, value, 5, MAX_MAZE_SIZE, &number))) options->width = (int)number;
+        } else if (strcmp(option, "--height") == 0) {
+            if ((ok = parseBatchInteger(option, value, 5, MAX_MAZE_SIZE, &number))) options->height = (int)number;
+        } else if (strcmp(option, "--density") == 0) {
+            char* end;
+            options->density = strtof(value, &end);
+            ok = *value != '\0' && *end == '\0' && options->density >= 0.1f && options->density <= 0.4f;
+            if (!ok) fprintf(stderr, "--density needs a number from 0.1 to 0.4!\n");
+        } else if (strcmp(option, "--weights") == 0) {
+            if ((ok = parseBatchInteger(option, value, 1, MAZE_MAX_WEIGHT, &number))) options->maxWeight = (int)number;
+        } else if (strcmp(option, "--file") == 0) {
+            options->file = value;
+        } else if (strcmp(option, "--seed") == 0) {
+            ok = parseBatchSeed(value, &options->seed);
+        } else if (strcmp(option, "--threads") == 0) {
+            if ((ok = parseBatchInteger(option, value, 1, MAX_MAZE_THREADS, &number))) options->threads = (int)number;
+        } else if (strcmp(option, "--repeat") == 0) {
+            if ((ok = parseBatchInteger(option, value, 1, 100000000, &number))) options->repeat = (int)number;
+        } else if (strcmp(option, "--format") == 0) {
+            options->csv = strcmp(value, "csv") == 0;
+            ok = options->csv || strcmp(value, "json") == 0;
+            if (!ok) fprintf(stderr, "Unknown format %s!\n", value);
+        } else if (strcmp(option, "--board") == 0) {
+            if ((ok = parseBatchInteger(option, value, 3, MAX_BOARD_SIZE, &number))) options->boardSize = (int)number;
+        } else if (strcmp(option, "--win") == 0) {
+            if ((ok = parseBatchInteger(option, value, 3, MAX_BOARD_SIZE, &number))) options->winLength = (int)number;
+        } else if (strcmp(option, "--x-level") == 0) {
+            if ((ok = parseBatchInteger(option, value, 0, 3, &number))) options->xLevel = (int)number;
+        } else if (strcmp(option, "--o-level") == 0) {
+            if ((ok = parseBatchInteger(option, value, 0, 3, &number))) options->oLevel = (int)number;
+        } else if (strcmp(option, "--games") == 0) {
+            ok = parseBatchInteger(option, value, 1, 100000000, &options->games);
+        } else if (strcmp(option, "--move-ms") == 0) {
+            if ((ok = parseBatchInteger(option, value, 1, 10000, &number))) options->moveTimeMs = (int)number;
+        } else if (strcmp(option, "--engine") == 0) {
+            options->searchEngine = strcmp(value, "mcts") == 0 ? SEARCH_MCTS : SEARCH_ALPHA_BETA;
+            ok = options->searchEngine == SEARCH_MCTS || strcmp(value, "alpha-beta") == 0;
+            if (!ok) fprintf(stderr, "Unknown engine %s!\n", value);
+        }
+        if (!ok) return 0;
+    }
+    
+    if (game == (options->solver >= 0)) {
+        fprintf(stderr, "Give exactly one of --maze and --game!\n");
+        return 0;
+    }
+    if (options->winLength == 0) options->winLength = options->boardSize < 5 ? options->boardSize : 5;
+    if (options->winLength > options->boardSize) {
+        fprintf(stderr, "--win cannot be more than --board!\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Fresh maze for run, generated from seed + run or loaded from the file.
+static int setUpBatchMaze(const BatchOptions* options, int run, Maze* maze) {
+    if (options->file != NULL) return loadMaze(maze, options->file);
+    generateSeededMaze(maze, options->width, options->height, options->generator, options->density, options->maxWeight,
+                       options->seed + (unsigned long long)run);
+    return 1;
+}
+
+// Setup covers generating or loading the maze, plus building the
+// hierarchy for hpa; solving is the query or search alone.
+static int runBatchMazes(const BatchOptions* options) {
+    const char* algorithm = mazeSolverName(options->solver);
+    int hpa = mazeSolverUsesHierarchy(options->solver);
+    if (options->csv) printf("run,algorithm,width,height,seed,found,pathLength,pathCost,nodes,setupNanos,solveNanos\n");
+    for (int run = 0; run < options->repeat; run++) {
+        Maze maze;
+        MazeHierarchy hierarchy;
+        long long start = monotonicNanos();
+        if (!setUpBatchMaze(options, run, &maze)) return 1;
+        if (hpa) initMazeHierarchy(&hierarchy, &maze, options->threads);
+        long long setupNanos = monotonicNanos() - start;
+        
+        MazePath path = {NULL, 0};
+        long long nodes = 0;
+        start = monotonicNanos();
+        int found = runMazeSolver(options->solver, &maze, &hierarchy, options->threads, &path, &nodes);
+        long long solveNanos = monotonicNanos() - start;
+        
+        unsigned long long seed = options->file != NULL ? 0 : options->seed + (unsigned long long)run;
+        long long pathCost = found ? mazePathCost(&maze, &path) : -1;
+        long long pathLength = found ? path.length : 0;
+        if (options->csv) {
+            printf("%d,%s,%d,%d,%llu,%d,%lld,%lld,%lld,%lld,%lld\n", run, algorithm, maze.width, maze.height,
+                   seed, found, pathLength, pathCost, nodes, setupNanos, solveNanos);
+        } else {
+            printf("{\"type\":\"maze\",\"run\":%d,\"algorithm\":\"%s\",\"width\":%d,\"height\":%d,\"seed\":%llu,"
+                   "\"found\":%s,\"pathLength\":%lld,\"pathCost\":%lld,\"nodes\":%lld,\"setupNanos\":%lld,\"solveNanos\":%lld}\n",
+                   run, algorithm, maze.width, maze.height, seed,
+                   found ? "true" : "false", pathLength, pathCost, nodes, setupNanos, solveNanos);
+        }
+        freeMazePath(&path);
+        if (hpa) freeMazeHierarchy(&hierarchy);
+        freeMaze(&maze);
+    }
+    return 0;
+}
+
+static int runBatchGames(const BatchOptions* options) {
+    TicTacToeConfig engine;
+    getTicTacToeConfig(&engine);
+    engine.size = options->boardSize;
+    engine.winLength = options->winLength;
+    engine.moveTimeMs = options->boardSize > 3 ? options->moveTimeMs : DEFAULT_MOVE_TIME_MS;
+    engine.searchEngine = options->searchEngine;
+    engine.maxDepth = 0;
+    engine.threads = 1;         // parallelism comes from playing games concurrently
+    engine.verbose = 0;
+    configureTicTacToe(&engine);
+    
+    if (options->csv) printf("run,size,winLength,xLevel,oLevel,seed,games,xWins,draws,oWins,moves,nodes,nanos\n");
+    for (int run = 0; run < options->repeat; run++) {
+        SelfPlayConfig config;
+        SelfPlayResult result;
+        config.games = options->games;
+        config.threads = options->threads < MAX_SELF_PLAY_THREADS ? options->threads : MAX_SELF_PLAY_THREADS;
+        config.xLevel = options->xLevel;
+        config.oLevel = options->oLevel;
+        config.seed = options->seed + (unsigned long long)run;
+        runSelfPlay(&config, &result);
+        long long nanos = (long long)(result.seconds * 1e9);
+        if (options->csv) {
+            printf("%d,%d,%d,%d,%d,%llu,%lld,%lld,%lld,%lld,%lld,%lld,%lld\n", run, engine.size, engine.winLength,
+                   config.xLevel, config.oLevel, config.seed, result.games, result.xWins, result.draws, result.oWins,
+                   result.moves, result.nodes, nanos);
+        } else {
+            printf("{\"type\":\"selfplay\",\"run\":%d,\"size\":%d,\"winLength\":%d,\"xLevel\":%d,\"oLevel\":%d,\"seed\":%llu,"
+                   "\"games\":%lld,\"xWins\":%lld,\"draws\":%lld,\"oWins\":%lld,\"moves\":%lld,\"nodes\":%lld,\"nanos\":%lld}\n",
+                   run, engine.size, engine.winLength, config.xLevel, config.oLevel, config.seed,
+                   result.games, result.xWins, result.draws, result.oWins, result.moves, result.nodes, nanos);
+        }
+    }
+    return 0;
+}
+
+// Entry point for any command line with options; returns the exit status.
+int runBatchCommand(int argc, char** argv) {
+    BatchOptions options;
+    if (!parseBatchOptions(argc, argv, &options)) {
+        printBatchUsage(stderr);
+        return 2;
+    }
+    return options.solver >= 0 ? runBatchMazes(&options) : runBatchGames(&options);
+}
\ No newline at end of file
@@ -0,0 +1,596 @@
+#include "ai_agent.h"
+#include <math.h>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Benchmark Suite
+// Separate executable (make benchmark) that times every maze solver over a
+// sweep of sizes, wall densities, generators and seeds, and the Tic-Tac-Toe
+// engines over a fixed corpus of positions. A case is one maze or one
+// position timed over repeated runs, so its median, tail times and median
+// absolute deviation (MAD) describe that input alone. Each case also
+// reports ns per node, nodes per second and the peak memory it adds, and
+// the table can be saved as a baseline and compared against on later runs.
+
+#define BENCH_MAX_SAMPLES 100
+#define BENCH_MIN_SAMPLE_NANOS 1000000   // tiny solves are timed in batches at least this long
+#define BENCH_CASE_NANOS 100000000       // cheap cases keep sampling up to this budget
+#define BENCH_MAX_SEEDS 16
+#define BENCH_DEFAULT_TOLERANCE 10   // percent slower than baseline that counts as a regression
+#define BENCH_MAD_MULTIPLE 3         // ... and by more than this many of the case's MADs
+#define BENCH_DRIFT_CASES 16         // fewer compared cases are too few to tell drift from a real change
+
+// Maze layouts: density is only used by the noise generator.
+typedef struct {
+    const char* name;
+    int generator;
+    float density;
+    int maxWeight;
+} BenchLayout;
+
+static const BenchLayout benchLayouts[] = {
+    {"noise10", MAZE_GEN_NOISE, 0.10f, 1},
+    {"noise25", MAZE_GEN_NOISE, 0.25f, 1},
+    {"noise35", MAZE_GEN_NOISE, 0.35f, 1},
+    {"backtracker", MAZE_GEN_BACKTRACKER, 0.0f, 1},
+    {"terrain", MAZE_GEN_NOISE, 0.25f, MAZE_MAX_WEIGHT},
+};
+
+#define BENCH_LAYOUTS ((int)(sizeof(benchLayouts) / sizeof(benchLayouts[0])))
+
+static const int quickSizes[] = {101, 501};
+static const int fullSizes[] = {101, 501, 2001};
+
+#define QUICK_SIZES ((int)(sizeof(quickSizes) / sizeof(quickSizes[0])))
+#define FULL_SIZES ((int)(sizeof(fullSizes) / sizeof(fullSizes[0])))
+
+// Tic-Tac-Toe corpus: rows of 'X', 'O' and '.', X (the AI) to move. The
+// depth cap and a generous time limit make every search do the same work.
+typedef struct {
+    const char* name;
+    int size, winLength;
+    int maxDepth;
+    int searchEngine;
+    const char* cells;
+} BenchPosition;
+
+static const BenchPosition benchPositions[] = {
+    {"4x4-empty", 4, 4, 8, SEARCH_ALPHA_BETA,
+     "................"},
+    {"4x4-open", 4, 4, 10, SEARCH_ALPHA_BETA,
+     ".....X....O....."},
+    {"4x4-middle", 4, 4, 12, SEARCH_ALPHA_BETA,
+     "X..O.XO...O..X.."},
+    {"5x5-open", 5, 4, 7, SEARCH_ALPHA_BETA,
+     "............X.......O...."},
+    {"5x5-threat", 5, 4, 8, SEARCH_ALPHA_BETA,
+     "......X....XO....O......."},
+    {"6x6-open", 6, 5, 5, SEARCH_ALPHA_BETA,
+     "..............XO.........O..X......."},
+    {"7x7-open", 7, 5, 5, SEARCH_ALPHA_BETA,
+     "................O.......X.....X.O................"},
+    {"5x5-mcts", 5, 4, 0, SEARCH_MCTS,
+     "......X....XO....O......."},
+};
+
+#define BENCH_POSITIONS ((int)(sizeof(benchPositions) / sizeof(benchPositions[0])))
+#define BENCH_MCTS_MILLIS 200   // MCTS has no depth cap, so it runs for a fixed time instead
+
+typedef struct {
+    char name[64];
+    int samples;
+    long long medianNanos, p90Nanos, p99Nanos;
+    long long madNanos;         // median absolute deviation from the median
+    double nanosPerNode;
+    double nodesPerSecond;
+    long long peakKb;           // peak resident memory over the size at reset
+    int timeBounded;            // runs for a fixed time, so compare judges ns/node
+    double nanosPerNodeMad;     // MAD of the per-sample ns/node, time-bounded cases only
+    double value, valueMad;     // what compare judges: median ns, or ns/node
+    double baselineValue;       // the same from the baseline file, 0 if none
+    double baselineMad;
+} BenchResult;
+
+typedef struct {
+    int quick;
+    int repeat;
+    int seeds;
+    int threads;
+    int mazes, games;
+    const char* filter;
+    const char* saveFile;
+    const char* compareFile;
+    int tolerance;
+} BenchOptions;
+
+static BenchResult* benchResults = NULL;   // room for every case in the sweep, see countBenchCases
+static int benchResultCount = 0;
+static int peakResetWorks = -1;
+static long long peakBaseKb = 0;
+
+// Reads a "Name:   123 kB" field of /proc/self/status, or -1.
+static long long readStatusKb(const char* field) {
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file == NULL) return -1;
+    char line[256];
+    long long kb = -1;
+    size_t length = strlen(field);
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, field, length) == 0) kb = atoll(line + length);
+    }
+    fclose(file);
+    return kb;
+}
+
+// Peak memory a case adds, in KB. Writing 5 to clear_refs resets the
+// kernel's high-water mark to the current resident size, which still
+// holds the program and whatever heap the allocator kept from earlier
+// cases, so that size is recorded here and subtracted from the peak.
+// Without the reset (not Linux, or no permission) the whole-process peak
+// from getrusage is reported instead.
+static void resetPeakMemory() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    FILE* file = peakResetWorks != 0 ? fopen("/proc/self/clear_refs", "w") : NULL;
+    if (file != NULL) {
+        peakResetWorks = fputs("5", file) >= 0;
+        if (fclose(file) != 0) peakResetWorks = 0;
+    } else {
+        peakResetWorks = 0;
+    }
+    if (peakResetWorks) peakBaseKb = readStatusKb("VmRSS:");
+    if (peakBaseKb < 0) peakResetWorks = 0;
+}
+
+static long long readPeakMemory() {
+    if (peakResetWorks) {
+        long long kb = readStatusKb("VmHWM:");
+        if (kb >= 0) return kb > peakBaseKb ? kb - peakBaseKb : 0;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static int compareNanos(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples.
+static long long percentile(const long long* sorted, int count, int percent) {
+    int rank = (count * percent + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// sampleNodes holds each sample's node count for a time-bounded case,
+// whose time says nothing, and is NULL for the rest.
+static void recordResult(const char* name, long long* nanos, int samples, long long nodes, const long long* sampleNodes,
+                         long long peakKb) {
+    BenchResult* result = &benchResults[benchResultCount++];
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    
+    long long total = 0;
+    for (int i = 0; i < samples; i++) total += nanos[i];
+    qsort(nanos, samples, sizeof(long long), compareNanos);
+    result->samples = samples;
+    result->medianNanos = percentile(nanos, samples, 50);
+    result->p90Nanos = percentile(nanos, samples, 90);
+    result->p99Nanos = percentile(nanos, samples, 99);
+    long long deviations[BENCH_MAX_SAMPLES];
+    for (int i = 0; i < samples; i++) deviations[i] = llabs(nanos[i] - result->medianNanos);
+    qsort(deviations, samples, sizeof(long long), compareNanos);
+    result->madNanos = percentile(deviations, samples, 50);
+    result->nanosPerNode = nodes > 0 ? (double)total / nodes : 0.0;
+    result->nodesPerSecond = total > 0 ? nodes * 1e9 / total : 0.0;
+    result->peakKb = peakKb;
+    result->value = (double)result->medianNanos;
+    result->valueMad = (double)result->madNanos;
+    if (sampleNodes != NULL) {
+        double perNode[BENCH_MAX_SAMPLES];
+        for (int i = 0; i < samples; i++) perNode[i] = sampleNodes[i] > 0 ? (double)nanos[i] / sampleNodes[i] : 0.0;
+        qsort(perNode, samples, sizeof(double), compareDoubles);
+        double medianPerNode = perNode[(samples - 1) / 2];
+        for (int i = 0; i < samples; i++) perNode[i] = fabs(perNode[i] - medianPerNode);
+        qsort(perNode, samples, sizeof(double), compareDoubles);
+        result->timeBounded = 1;
+        result->nanosPerNodeMad = perNode[(samples - 1) / 2];
+        result->value = result->nanosPerNode;
+        result->valueMad = result->nanosPerNodeMad;
+    }
+    
+    printf("%-40s %5d %11.3f %11.3f %11.3f %10.3f %10.2f %10.2f %9.1f\n", result->name, samples,
+           result->medianNanos / 1e6, result->p90Nanos / 1e6, result->p99Nanos / 1e6, result->madNanos / 1e6,
+           result->nanosPerNode, result->nodesPerSecond / 1e6, peakKb / 1024.0);
+    fflush(stdout);
+}
+
+// Timed samples for a case whose sample takes `sampleNanos`: at least
+// `repeat`, and more for cheap cases up to BENCH_CASE_NANOS so their tail
+// percentiles are not just the slowest of a handful.
+static int benchSampleCount(const BenchOptions* options, long long sampleNanos) {
+    long long budgeted = BENCH_CASE_NANOS / (sampleNanos > 0 ? sampleNanos : 1);
+    if (budgeted > BENCH_MAX_SAMPLES) return BENCH_MAX_SAMPLES;
+    return budgeted > options->repeat ? (int)budgeted : options->repeat;
+}
+
+// Solves the maze once and returns the nodes explored.
+static long long solveBenchMaze(const BenchOptions* options, int solver, Maze* maze, MazeHierarchy* hierarchy) {
+    MazePath path = {NULL, 0};
+    long long explored = 0;
+    runMazeSolver(solver, maze, hierarchy, options->threads, &path, &explored);
+    freeMazePath(&path);
+    return explored;
+}
+
+// One solver on one seeded maze of a layout and size: an untimed run warms
+// the caches and the allocator, then every timed sample solves the same
+// maze, so the spread is timing noise rather than easy and hard mazes
+// mixed together. Solves shorter than BENCH_MIN_SAMPLE_NANOS are repeated
+// within each sample and averaged, since a few microseconds of scheduler
+// or cache disturbance would otherwise swing them by tens of percent. The
+// peak covers the maze plus the solver's own memory. HPA* times the query
+// alone; building the hierarchy is a one-off cost it amortizes.
+static void benchMazeCase(const BenchOptions* options, const char* name, int solver, const BenchLayout* layout, int size,
+                          unsigned long long seed) {
+    long long nanos[BENCH_MAX_SAMPLES];
+    long long nodes = 0;
+    int hpa = mazeSolverUsesHierarchy(solver);
+    Maze maze;
+    MazeHierarchy hierarchy;
+    resetPeakMemory();
+    generateSeededMaze(&maze, size, size, layout->generator, layout->density, layout->maxWeight, seed);
+    if (hpa) initMazeHierarchy(&hierarchy, &maze, options->threads);
+    
+    long long start = monotonicNanos();
+    solveBenchMaze(options, solver, &maze, &hierarchy);
+    long long warmUp = monotonicNanos() - start;
+    if (warmUp < 1) warmUp = 1;
+    int batch = warmUp >= BENCH_MIN_SAMPLE_NANOS ? 1 : (int)(BENCH_MIN_SAMPLE_NANOS / warmUp);
+    int samples = benchSampleCount(options, warmUp * batch);
+    for (int sample = 0; sample < samples; sample++) {
+        long long explored = 0;
+        start = monotonicNanos();
+        for (int run = 0; run < batch; run++) explored = solveBenchMaze(options, solver, &maze, &hierarchy);
+        nanos[sample] = (monotonicNanos() - start) / batch;
+        nodes += explored;
+    }
+    long long peakKb = readPeakMemory();
+    
+    if (hpa) freeMazeHierarchy(&hierarchy);
+    freeMaze(&maze);
+    recordResult(name, nanos, samples, nodes, NULL, peakKb);
+}
+
+static void setUpBenchBoard(Bitboard* board, const BenchPosition* position) {
+    memset(board, 0, sizeof(*board));
+    for (int cell = 0; cell < position->size * position->size; cell++) {
+        char c = position->cells[cell];
+        if (c == 'X' || c == 'O') setCell(board, cell / position->size, cell % position->size, c == 'X' ? 1 : -1);
+    }
+}
+
+static void configureBenchEngine(const BenchPosition* position) {
+    TicTacToeConfig engine;
+    getTicTacToeConfig(&engine);
+    engine.size = position->size;
+    engine.winLength = position->winLength;
+    engine.maxDepth = position->maxDepth;
+    engine.moveTimeMs = position->searchEngine == SEARCH_MCTS ? BENCH_MCTS_MILLIS : 600000;
+    engine.searchEngine = position->searchEngine;
+    engine.threads = 1;
+    engine.verbose = 0;
+    configureTicTacToe(&engine);
+}
+
+// Each sample starts from an empty transposition table and MCTS tree, so
+// the position is searched from scratch every time. The first search is
+// an untimed warm-up that also sizes the number of samples.
+static void benchGameCase(const BenchOptions* options, const char* name, const BenchPosition* position) {
+    configureBenchEngine(position);
+    
+    long long nanos[BENCH_MAX_SAMPLES], sampleNodes[BENCH_MAX_SAMPLES];
+    long long nodes = 0;
+    long long peakKb = 0;
+    int samples = options->repeat;
+    for (int sample = -1; sample < samples; sample++) {
+        Bitboard board;
+        TranspositionTable tt;
+        MctsTree mcts;
+        SearchStats stats;
+        Rng rng;
+        memset(&tt, 0, sizeof(tt));
+        memset(&mcts, 0, sizeof(mcts));
+        memset(&stats, 0, sizeof(stats));
+        rngSeed(&rng, (unsigned long long)sample + 2);
+        setUpBenchBoard(&board, position);
+        
+        resetPeakMemory();
+        long long start = monotonicNanos();
+        getAIMoveWithDifficulty(&board, &tt, &mcts, &stats, 3, &rng);
+        long long elapsed = monotonicNanos() - start;
+        long long peak = readPeakMemory();
+        if (peak > peakKb) peakKb = peak;
+        
+        freeTranspositionTable(&tt);
+        freeMctsTree(&mcts);
+        if (sample < 0) {
+            samples = benchSampleCount(options, elapsed);
+            continue;
+        }
+        nanos[sample] = elapsed;
+        sampleNodes[sample] = stats.nodes;
+        nodes += stats.nodes;
+    }
+    
+    recordResult(name, nanos, samples, nodes, position->searchEngine == SEARCH_MCTS ? sampleNodes : NULL, peakKb);
+}
+
+static int matchesFilter(const BenchOptions* options, const char* name) {
+    return options->filter == NULL || strstr(name, options->filter) != NULL;
+}
+
+// Time-to-depth speedup of both parallel alpha-beta modes with --threads
+// threads over one thread, for every alpha-beta position. It depends on
+// the machine's core count, so it is printed after the table and is not
+// part of baselines.
+static void benchSearchSpeedups(const BenchOptions* options) {
+    static const struct {
+        const char* name;
+        int mode;
+    } modes[] = {{"root-split", PARALLEL_ROOT_SPLIT}, {"lazy-smp", PARALLEL_LAZY_SMP}};
+    int threads = options->threads < MAX_SEARCH_THREADS ? options->threads : MAX_SEARCH_THREADS;
+    int printed = 0;
+    if (threads < 2) return;
+    
+    for (int p = 0; p < BENCH_POSITIONS; p++) {
+        const BenchPosition* position = &benchPositions[p];
+        if (position->searchEngine != SEARCH_ALPHA_BETA) continue;
+        for (int m = 0; m < 2; m++) {
+            char name[64];
+            snprintf(name, sizeof(name), "ttt/speedup/%s/%s", modes[m].name, position->name);
+            if (!matchesFilter(options, name)) continue;
+            if (!printed++) printf("\nParallel search speedup, %d threads over 1, to each position's depth:\n", threads);
+            Bitboard board;
+            configureBenchEngine(position);
+            setUpBenchBoard(&board, position);
+            printf("%-40s ", name);
+            measureSearchSpeedup(&board, threads, modes[m].mode, position->maxDepth);
+        }
+    }
+}
+
+// Baseline files hold one case per line: name, samples, median, p90, p99
+// and MAD in nanoseconds, ns per node, peak KB and the MAD of ns per node
+// (0 unless time-bounded). Lines starting with # are comments.
+static int saveBaseline(const char* fileName) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot write %s!\n", fileName);
+        return 0;
+    }
+    fprintf(file, "# case runs median p90 p99 mad (ns) ns/node casePeakKb ns/node-mad\n");
+    for (int i = 0; i < benchResultCount; i++) {
+        const BenchResult* result = &benchResults[i];
+        fprintf(file, "%s %d %lld %lld %lld %lld %.3f %lld %.3f\n", result->name, result->samples, result->medianNanos,
+                result->p90Nanos, result->p99Nanos, result->madNanos, result->nanosPerNode, result->peakKb,
+                result->nanosPerNodeMad);
+    }
+    fclose(file);
+    printf("\nSaved %d cases to %s\n", benchResultCount, fileName);
+    return 1;
+}
+
+// A whole run can drift tens of percent with the machine's clock and load,
+// so with at least BENCH_DRIFT_CASES cases every case is judged against
+// the median change across the suite, which is reported on its own. A
+// case is judged by its median time, or by ns per node if it runs for a
+// fixed time (MCTS), and regresses when that is more than `tolerance`
+// percent slower than the drift and the slowdown is over
+// BENCH_MAD_MULTIPLE times the larger of the two runs' MADs, so the noise
+// floor scales with how steady each case is.
+// Returns the number of regressions, or -1 if the file cannot be read.
+static int compareBaseline(const char* fileName, int tolerance) {
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot read %s!\n", fileName);
+        return -1;
+    }
+    char line[256], name[64];
+    int samples;
+    long long median, p90, p99, mad, peakKb;
+    double nanosPerNode, nanosPerNodeMad;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        nanosPerNodeMad = 0.0;
+        if (line[0] == '#' || sscanf(line, "%63s %d %lld %lld %lld %lld %lf %lld %lf", name, &samples, &median, &p90, &p99,
+                                     &mad, &nanosPerNode, &peakKb, &nanosPerNodeMad) < 8) continue;
+        for (int i = 0; i < benchResultCount; i++) {
+            BenchResult* result = &benchResults[i];
+            if (strcmp(result->name, name) != 0) continue;
+            result->baselineValue = result->timeBounded ? nanosPerNode : (double)median;
+            result->baselineMad = result->timeBounded ? nanosPerNodeMad : (double)mad;
+        }
+    }
+    fclose(file);
+    
+    double* ratios = (double*)malloc((benchResultCount + 1) * sizeof(double));
+    if (ratios == NULL) {
+        printf("Memory allocation failed for benchmark ratios!\n");
+        exit(1);
+    }
+    int compared = 0, regressions = 0;
+    for (int i = 0; i < benchResultCount; i++) {
+        if (benchResults[i].baselineValue > 0) ratios[compared++] = benchResults[i].value / benchResults[i].baselineValue;
+    }
+    qsort(ratios, compared, sizeof(double), compareDoubles);
+    double drift = compared > 0 ? ratios[(compared - 1) / 2] : 1.0;
+    free(ratios);
+    int normalized = compared >= BENCH_DRIFT_CASES;
+    
+    printf("\nCompared with %s (median time or ns/node, %d%% and %d MAD tolerance):\n", fileName, tolerance, BENCH_MAD_MULTIPLE);
+    printf("  whole suite %+.1f%%%s\n", 100.0 * (drift - 1.0), normalized ? "; cases below are relative to that" : "");
+    if (!normalized) drift = 1.0;
+    for (int i = 0; i < benchResultCount; i++) {
+        const BenchResult* result = &benchResults[i];
+        if (result->baselineValue <= 0) continue;
+        double expected = result->baselineValue * drift;
+        double delta = result->value - expected;
+        double change = 100.0 * delta / expected;
+        double mad = result->valueMad > result->baselineMad * drift ? result->valueMad : result->baselineMad * drift;
+        if (fabs(delta) <= BENCH_MAD_MULTIPLE * mad) continue;
+        double scale = result->timeBounded ? 1.0 : 1e6;
+        const char* unit = result->timeBounded ? "ns/node" : "ms";
+        if (change > tolerance) {
+            regressions++;
+            printf("  REGRESSION %-40s %11.3f -> %11.3f %s (%+.1f%%)\n", result->name,
+                   result->baselineValue / scale, result->value / scale, unit, change);
+        } else if (change < -tolerance) {
+            printf("  faster     %-40s %11.3f -> %11.3f %s (%+.1f%%)\n", result->name,
+                   result->baselineValue / scale, result->value / scale, unit, change);
+        }
+    }
+    printf("%d of %d cases compared, %d regressions\n", compared, benchResultCount, regressions);
+    return regressions;
+}
+
+static void printBenchUsage(FILE* out) {
+    fprintf(out,
+        "Usage: benchmark [options]\n"
+        "  --quick             skip the largest mazes\n"
+        "  --repeat N          timed runs per case at least, 1-%d (default 7)\n"
+        "  --seeds N           mazes per layout and size, 1-%d (default 3, quick 2)\n"
+        "  --threads N         threads for parallel BFS, HPA* builds and the game search\n"
+        "                      speedup, 1-%d (default 4)\n"
+        "  --only mazes|games  run one half of the suite\n"
+        "  --filter TEXT       only cases whose name contains TEXT\n"
+        "  --save FILE         write the results as a baseline\n"
+        "  --compare FILE      compare with a baseline; exit 1 on regressions\n"
+        "  --tolerance PCT     slowdown that counts as a regression (default %d)\n",
+        BENCH_MAX_SAMPLES, BENCH_MAX_SEEDS, MAX_MAZE_THREADS, BENCH_DEFAULT_TOLERANCE);
+}
+
+static int parseBenchOptions(int argc, char** argv, BenchOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->repeat = 0;
+    options->threads = 4;
+    options->mazes = options->games = 1;
+    options->tolerance = BENCH_DEFAULT_TOLERANCE;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* option = argv[i];
+        if (strcmp(option, "--help") == 0) {
+            printBenchUsage(stdout);
+            exit(0);
+        }
+        if (strcmp(option, "--quick") == 0) {
+            options->quick = 1;
+            continue;
+        }
+        if (i + 1 == argc) {
+            fprintf(stderr, "%s needs a value!\n", option);
+            return 0;
+        }
+        const char* value = argv[++i];
+        int number = atoi(value);
+        if (strcmp(option, "--repeat") == 0 && number >= 1 && number <= BENCH_MAX_SAMPLES) {
+            options->repeat = number;
+        } else if (strcmp(option, "--seeds") == 0 && number >= 1 && number <= BENCH_MAX_SEEDS) {
+            options->seeds = number;
+        } else if (strcmp(option, "--threads") == 0 && number >= 1 && number <= MAX_MAZE_THREADS) {
+            options->threads = number;
+        } else if (strcmp(option, "--tolerance") == 0 && number >= 1) {
+            options->tolerance = number;
+        } else if (strcmp(option, "--only") == 0 && (strcmp(value, "mazes") == 0 || strcmp(value, "games") == 0)) {
+            options->mazes = value[0] == 'm';
+            options->games = value[0] == 'g';
+        } else if (strcmp(option, "--filter") == 0) {
+            options->filter = value;
+        } else if (strcmp(option, "--save") == 0) {
+            options->saveFile = value;
+        } else if (strcmp(option, "--compare") == 0) {
+            options->compareFile = value;
+        } else {
+            fprintf(stderr, "Bad option %s %s!\n", option, value);
+            return 0;
+        }
+    }
+    if (options->repeat == 0) options->repeat = 7;
+    if (options->seeds == 0) options->seeds = options->quick ? 2 : 3;
+    return 1;
+}
+
+// Sizes the maze sweep runs over.
+static const int* benchSizes(const BenchOptions* options, int* count) {
+    *count = options->quick ? QUICK_SIZES : FULL_SIZES;
+    return options->quick ? quickSizes : fullSizes;
+}
+
+// Cases the options can run before the filter, so the results table is
+// sized once up front instead of overflowing after the slow cases ran.
+static int countBenchCases(const BenchOptions* options) {
+    int sizeCount, cases = 0;
+    benchSizes(options, &sizeCount);
+    if (options->mazes) cases += sizeCount * BENCH_LAYOUTS * mazeSolverCount() * options->seeds;
+    if (options->games) cases += BENCH_POSITIONS;
+    return cases;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseBenchOptions(argc, argv, &options)) {
+        printBenchUsage(stderr);
+        return 2;
+    }
+    benchResults = (BenchResult*)malloc((countBenchCases(&options) + 1) * sizeof(BenchResult));
+    if (benchResults == NULL) {
+        printf("Memory allocation failed for benchmark results!\n");
+        exit(1);
+    }
+    
+    printf("%-40s %5s %11s %11s %11s %10s %10s %10s %9s\n", "case", "runs", "median ms", "p90 ms", "p99 ms",
+           "MAD ms", "ns/node", "Mnodes/s", "case MB");
+    if (options.mazes) {
+        int sizeCount;
+        const int* sizes = benchSizes(&options, &sizeCount);
+        for (int s = 0; s < sizeCount; s++) {
+            for (int l = 0; l < BENCH_LAYOUTS; l++) {
+                for (int solver = 0; solver < mazeSolverCount(); solver++) {
+                    for (int seed = 1; seed <= options.seeds; seed++) {
+                        char name[64];
+                        snprintf(name, sizeof(name), "maze/%s/%s/%d/s%d", mazeSolverName(solver), benchLayouts[l].name,
+                                 sizes[s], seed);
+                        if (matchesFilter(&options, name)) benchMazeCase(&options, name, solver, &benchLayouts[l], sizes[s], seed);
+                    }
+                }
+            }
+        }
+    }
+    if (options.games) {
+        for (int p = 0; p < BENCH_POSITIONS; p++) {
+            char name[64];
+            snprintf(name, sizeof(name), "ttt/%s/%s", benchPositions[p].searchEngine == SEARCH_MCTS ? "mcts" : "alpha-beta",
+                     benchPositions[p].name);
+            if (matchesFilter(&options, name)) benchGameCase(&options, name, &benchPositions[p]);
+        }
+    }
+    if (options.games) benchSearchSpeedups(&options);
+    if (!peakResetWorks) printf("(case MB is the whole process's peak; per-case reset is unavailable)\n");
+    
+    int status = 0;
+    if (options.saveFile != NULL && !saveBaseline(options.saveFile)) status = 2;
+    else if (options.compareFile != NULL) {
+        int regressions = compareBaseline(options.compareFile, options.tolerance);
+        status = regressions < 0 ? 2 : regressions > 0;
+    }
+    free(benchResults);
+    return status;
+}
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "ai_agent.h"
 
-int main() {
+int main(int argc, char** argv) {
+    // Any options select the non-interactive batch mode.
+    if (argc > 1) return runBatchCommand(argc, argv);
+    
     printf("========================================\n");
     printf("      AI AGENT: Games & Algorithms\n");
     printf("========================================\n");
@@ -10,9 +13,20 @@ int main() {
         printf("1. Tic-Tac-Toe with AI Levels\n");
         printf("2. Maze Solver with BFS\n");
         printf("3. Maze Solver with DFS\n");
-        printf("4. Exit\n");
+        printf("4. Maze Solver with A*\n");
+        printf("5. Maze Solver with Jump Point Search\n");
+        printf("6. Maze Solver with Bidirectional BFS\n");
+        printf("7. Maze Solver with Bit-Parallel BFS\n");
+        printf("8. Maze Solver with Parallel BFS\n");
+        printf("9. Maze Solver with Dijkstra (weighted terrain)\n");
+        printf("10. Maze Solver with Weighted A*\n");
+        printf("11. Maze Batch Queries\n");
+        printf("12. Maze Replanning with D* Lite\n");
+        printf("13. Maze Hierarchical Queries (HPA*)\n");
+        printf("14. Tic-Tac-Toe Self-Play Simulator\n");
+        printf("15. Exit\n");
         
-        int choice = getIntegerInput("Enter your choice (1-4): ", 1, 4);
+        int choice = getIntegerInput("Enter your choice (1-15): ", 1, 15);
         
         switch (choice) {
             case 1:
@@ -25,6 +39,39 @@ int main() {
                 solveMaze(2);  // DFS
                 break;
             case 4:
+                solveMaze(3);  // A*
+                break;
+            case 5:
+                solveMaze(4);  // Jump Point Search
+                break;
+            case 6:
+                solveMaze(5);  // Bidirectional BFS
+                break;
+            case 7:
+                solveMaze(6);  // Bit-parallel BFS
+                break;
+            case 8:
+                solveMaze(7);  // Parallel BFS
+                break;
+            case 9:
+                solveMaze(8);  // Dijkstra
+                break;
+            case 10:
+                solveMaze(9);  // Weighted A*
+                break;
+            case 11:
+                playMazeQueryBatch();
+                break;
+            case 12:
+                playMazeReplanning();
+                break;
+            case 13:
+                playMazeHierarchy();
+                break;
+            case 14:
+                playSelfPlaySimulator();
+                break;
+            case 15:
                 printf("Thanks for playing!\n");
                 return 0;
         }
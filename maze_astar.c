@@ -0,0 +1,291 @@
+#include "ai_agent.h"
+
+// Informed Maze Solvers
+// A* and Jump Point Search share an indexed binary min-heap keyed on
+// f = g + h, with ties going to the larger g so the search runs along
+// one shortest path instead of flooding every equal-cost cell.
+
+static void* callocMazeArray(size_t count, size_t size) {
+    // Only the pages a search touches are ever backed by memory.
+    void* array = calloc(count, size);
+    if (array == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    return array;
+}
+
+void initMazeHeap(MazeHeap* heap, size_t cells) {
+    heap->cells = NULL;
+    heap->keys = NULL;
+    heap->size = heap->capacity = 0;
+    heap->slot = (unsigned int*)callocMazeArray(cells, sizeof(unsigned int));
+}
+
+void freeMazeHeap(MazeHeap* heap) {
+    free(heap->cells);
+    free(heap->keys);
+    free(heap->slot);
+}
+
+static inline void placeHeapEntry(MazeHeap* heap, size_t i, unsigned int cell, unsigned long long key) {
+    heap->cells[i] = cell;
+    heap->keys[i] = key;
+    heap->slot[cell] = (unsigned int)i + 1;
+}
+
+static void siftHeapUp(MazeHeap* heap, size_t i) {
+    unsigned int cell = heap->cells[i];
+    unsigned long long key = heap->keys[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap->keys[parent] <= key) break;
+        placeHeapEntry(heap, i, heap->cells[parent], heap->keys[parent]);
+        i = parent;
+    }
+    placeHeapEntry(heap, i, cell, key);
+}
+
+// Inserts cell, or lowers its key if it is already queued with a larger one.
+void pushMazeHeap(MazeHeap* heap, unsigned int cell, unsigned long long key) {
+    if (heap->slot[cell] != 0) {
+        size_t i = heap->slot[cell] - 1;
+        if (key < heap->keys[i]) {
+            heap->keys[i] = key;
+            siftHeapUp(heap, i);
+        }
+        return;
+    }
+    if (heap->size == heap->capacity) {
+        heap->capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        heap->cells = (unsigned int*)realloc(heap->cells, heap->capacity * sizeof(unsigned int));
+        heap->keys = (unsigned long long*)realloc(heap->keys, heap->capacity * sizeof(unsigned long long));
+        if (heap->cells == NULL || heap->keys == NULL) {
+            printf("Memory allocation failed for maze search!\n");
+            exit(1);
+        }
+    }
+    heap->cells[heap->size] = cell;
+    heap->keys[heap->size] = key;
+    siftHeapUp(heap, heap->size++);
+}
+
+// Moves the entry at i down to where key belongs.
+static void siftHeapDown(MazeHeap* heap, size_t i, unsigned int cell, unsigned long long key) {
+    while (1) {
+        size_t child = 2 * i + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && heap->keys[child + 1] < heap->keys[child]) child++;
+        if (key <= heap->keys[child]) break;
+        placeHeapEntry(heap, i, heap->cells[child], heap->keys[child]);
+        i = child;
+    }
+    placeHeapEntry(heap, i, cell, key);
+}
+
+unsigned int popMazeHeap(MazeHeap* heap) {
+    unsigned int top = heap->cells[0];
+    heap->slot[top] = 0;
+    if (--heap->size > 0) siftHeapDown(heap, 0, heap->cells[heap->size], heap->keys[heap->size]);
+    return top;
+}
+
+// Takes cell out of the heap if it is queued.
+void removeMazeHeap(MazeHeap* heap, unsigned int cell) {
+    if (heap->slot[cell] == 0) return;
+    size_t i = heap->slot[cell] - 1;
+    heap->slot[cell] = 0;
+    if (--heap->size == i) return;
+    
+    // The last entry fills the hole and moves whichever way its key says.
+    unsigned int last = heap->cells[heap->size];
+    unsigned long long key = heap->keys[heap->size];
+    if (i > 0 && key < heap->keys[(i - 1) / 2]) {
+        placeHeapEntry(heap, i, last, key);
+        siftHeapUp(heap, i);
+    } else {
+        siftHeapDown(heap, i, last, key);
+    }
+}
+
+// Smaller f first, then larger g.
+static inline unsigned long long heapKey(unsigned int g, unsigned int h) {
+    return ((unsigned long long)(g + h) << 32) | (0xFFFFFFFFu - g);
+}
+
+int aStarSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    size_t cells = mazeWords(maze) * 64;
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    // search.unvisited is cleared on expansion, so it is the open-and-not-closed set.
+    MazeSearch search;
+    MazeHeap heap;
+    unsigned int* cost = (unsigned int*)callocMazeArray(cells, sizeof(unsigned int));   // g + 1, 0 = unreached
+    int found = 0;
+    
+    initMazeSearch(&search, maze);
+    initMazeHeap(&heap, cells);
+    cost[startCell] = 1;
+    pushMazeHeap(&heap, startCell, heapKey(0, mazeManhattan(maze, startCell, endCell)));
+    *nodesExplored = 0;
+    
+    while (heap.size > 0) {
+        unsigned int current = popMazeHeap(&heap);
+        clearMazeBit(search.unvisited, current);
+        (*nodesExplored)++;
+        
+        if (current == endCell) {
+            buildMazePath(maze, &search, startCell, current, path);
+            found = 1;
+            break;
+        }
+        
+        unsigned int g = cost[current];     // g of current + 1 = g of a neighbour
+        int neighbours = mazeNeighbours(search.unvisited, current, maze->stride);
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            unsigned int next = current + mazeStep(maze, direction);
+            if (cost[next] != 0 && cost[next] <= g + 1) continue;
+            cost[next] = g + 1;
+            setParentDirection(&search, next, direction);
+            pushMazeHeap(&heap, next, heapKey(g, mazeManhattan(maze, next, endCell)));
+        }
+    }
+    
+    freeMazeHeap(&heap);
+    freeMazeSearch(&search);
+    free(cost);
+    return found;
+}
+
+// Jump Point Search for 4-connected grids. Canonical paths move
+// vertically first and turn horizontal; a horizontal run only turns
+// vertical where a wall forces it. Only the cells where that happens
+// (jump points) enter the heap.
+
+static inline int isOpenCell(const Maze* maze, unsigned int cell) {
+    return testMazeBit(maze->open, cell);
+}
+
+// True if stepping from cell to next horizontally uncovers a vertical
+// neighbour of next that is only reachable through next.
+static inline int hasForcedNeighbour(const Maze* maze, unsigned int cell, unsigned int next) {
+    unsigned int stride = maze->stride;
+    return (!isOpenCell(maze, cell - stride) && isOpenCell(maze, next - stride)) ||
+           (!isOpenCell(maze, cell + stride) && isOpenCell(maze, next + stride));
+}
+
+static unsigned int jumpHorizontal(const Maze* maze, unsigned int cell, int direction, unsigned int goal) {
+    int step = mazeStep(maze, direction);
+    while (1) {
+        unsigned int next = cell + step;
+        if (!isOpenCell(maze, next)) return MAZE_NO_CELL;
+        if (next == goal || hasForcedNeighbour(maze, cell, next)) return next;
+        cell = next;
+    }
+}
+
+// A vertical run stops wherever a horizontal run from it would find a
+// jump point, as diagonal moves do in 8-connected JPS.
+static unsigned int jumpVertical(const Maze* maze, unsigned int cell, int direction, unsigned int goal) {
+    int step = mazeStep(maze, direction);
+    while (1) {
+        unsigned int next = cell + step;
+        if (!isOpenCell(maze, next)) return MAZE_NO_CELL;
+        if (next == goal ||
+            jumpHorizontal(maze, next, 0, goal) != MAZE_NO_CELL ||
+            jumpHorizontal(maze, next, 2, goal) != MAZE_NO_CELL) return next;
+        cell = next;
+    }
+}
+
+// Directions worth searching from a jump point entered moving in arrival
+// (-1 for the start), as a mask with bit d for direction d.
+static int jumpDirections(const Maze* maze, unsigned int cell, int arrival) {
+    if (arrival < 0) return 0xF;
+    if (arrival == 1 || arrival == 3) return 1 << arrival | 1 << 0 | 1 << 2;
+    
+    unsigned int previous = cell - mazeStep(maze, arrival);
+    unsigned int stride = maze->stride;
+    int directions = 1 << arrival;
+    if (!isOpenCell(maze, previous + stride) && isOpenCell(maze, cell + stride)) directions |= 1 << 1;
+    if (!isOpenCell(maze, previous - stride) && isOpenCell(maze, cell - stride)) directions |= 1 << 3;
+    return directions;
+}
+
+// Expands the jump point chain into every cell on the path.
+static void buildJumpPath(const Maze* maze, const unsigned int* jumpParent, unsigned int start, unsigned int end, unsigned int length, MazePath* path) {
+    path->cells = (unsigned int*)malloc((size_t)length * sizeof(unsigned int));
+    if (path->cells == NULL) {
+        printf("Memory allocation failed for maze path!\n");
+        exit(1);
+    }
+    path->length = length;
+    
+    long long i = length - 1;
+    unsigned int cell = end;
+    while (cell != start) {
+        unsigned int parent = jumpParent[cell] - 1;
+        unsigned int segment = mazeManhattan(maze, parent, cell);
+        int step = ((int)cell - (int)parent) / (int)segment;
+        for (unsigned int k = 0; k < segment; k++) {
+            path->cells[i--] = cell;
+            cell -= step;
+        }
+    }
+    path->cells[i] = start;
+}
+
+int jpsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    size_t cells = mazeWords(maze) * 64;
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    // parentDir records the direction each jump point was entered in.
+    MazeSearch search;
+    MazeHeap heap;
+    unsigned int* cost = (unsigned int*)callocMazeArray(cells, sizeof(unsigned int));        // g + 1, 0 = unreached
+    unsigned int* jumpParent = (unsigned int*)callocMazeArray(cells, sizeof(unsigned int));  // parent + 1
+    int found = 0;
+    
+    initMazeSearch(&search, maze);
+    initMazeHeap(&heap, cells);
+    cost[startCell] = 1;
+    pushMazeHeap(&heap, startCell, heapKey(0, mazeManhattan(maze, startCell, endCell)));
+    *nodesExplored = 0;
+    
+    while (heap.size > 0) {
+        unsigned int current = popMazeHeap(&heap);
+        clearMazeBit(search.unvisited, current);
+        (*nodesExplored)++;
+        
+        if (current == endCell) {
+            buildJumpPath(maze, jumpParent, startCell, endCell, cost[endCell], path);
+            found = 1;
+            break;
+        }
+        
+        unsigned int g = cost[current] - 1;
+        int directions = jumpDirections(maze, current, current == startCell ? -1 : parentDirection(&search, current));
+        while (directions) {
+            int direction = __builtin_ctz(directions);
+            directions &= directions - 1;
+            unsigned int jump = (direction & 1) ? jumpVertical(maze, current, direction, endCell)
+                                                : jumpHorizontal(maze, current, direction, endCell);
+            if (jump == MAZE_NO_CELL || !testMazeBit(search.unvisited, jump)) continue;
+            
+            unsigned int jumpCost = g + mazeManhattan(maze, current, jump);
+            if (cost[jump] != 0 && cost[jump] <= jumpCost + 1) continue;
+            cost[jump] = jumpCost + 1;
+            jumpParent[jump] = current + 1;
+            setParentDirection(&search, jump, direction);
+            pushMazeHeap(&heap, jump, heapKey(jumpCost, mazeManhattan(maze, jump, endCell)));
+        }
+    }
+    
+    freeMazeHeap(&heap);
+    freeMazeSearch(&search);
+    free(cost);
+    free(jumpParent);
+    return found;
+}
\ No newline at end of file
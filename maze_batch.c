@@ -0,0 +1,397 @@
+#include "ai_agent.h"
+
+// Batch Maze Queries
+// A MazeEngine answers many start-to-end queries on one maze. Connected
+// components are labelled once, so a query between components is answered
+// without searching. Endpoints shared by several queries in a batch get a
+// full BFS distance field, kept between batches, which answers every query
+// that starts or ends there by lookup (the maze is undirected). The rest
+// run A*. Queries are spread over worker threads.
+
+// First position from position up to limit whose bit equals value, or
+// limit if there is none.
+static size_t findMazeBit(const unsigned long long* bits, size_t position, size_t limit, int value) {
+    while (position < limit) {
+        unsigned long long word = bits[position >> 6] ^ (value ? 0 : ~0ULL);
+        word &= ~0ULL << (position & 63);
+        if (word != 0) {
+            size_t found = (position & ~(size_t)63) + __builtin_ctzll(word);
+            return found < limit ? found : limit;
+        }
+        position = (position | 63) + 1;
+    }
+    return limit;
+}
+
+static unsigned int findRoot(unsigned int* parent, unsigned int run) {
+    while (parent[run] != run) {
+        parent[run] = parent[parent[run]];
+        run = parent[run];
+    }
+    return run;
+}
+
+static void* growBatchArray(void* array, size_t* capacity, size_t elementSize) {
+    size_t grown = *capacity ? *capacity * 2 : 1024;
+    array = realloc(array, grown * elementSize);
+    if (array == NULL) {
+        printf("Memory allocation failed for maze queries!\n");
+        exit(1);
+    }
+    *capacity = grown;
+    return array;
+}
+
+// Union-find over the horizontal runs of open cells: each run is joined
+// with the runs it overlaps in the row above, then every cell gets its
+// run's component.
+static void labelMazeComponents(MazeEngine* engine) {
+    const Maze* maze = engine->maze;
+    unsigned int* runStart = NULL;
+    unsigned int* runEnd = NULL;
+    unsigned int* parent = NULL;
+    size_t runs = 0, capacity = 0;
+    size_t* rowRuns = (size_t*)calloc((size_t)maze->height + 2, sizeof(size_t));   // first run of each row
+    if (rowRuns == NULL) {
+        printf("Memory allocation failed for maze queries!\n");
+        exit(1);
+    }
+    
+    for (int row = 1; row <= maze->height; row++) {
+        size_t base = (size_t)row * maze->stride;
+        rowRuns[row] = runs;
+        size_t column = findMazeBit(maze->open, base, base + maze->stride, 1);
+        while (column < base + maze->stride) {
+            size_t end = findMazeBit(maze->open, column, base + maze->stride, 0);
+            if (runs == capacity) {
+                size_t grown = capacity;
+                runStart = (unsigned int*)growBatchArray(runStart, &grown, sizeof(unsigned int));
+                grown = capacity;
+                runEnd = (unsigned int*)growBatchArray(runEnd, &grown, sizeof(unsigned int));
+                parent = (unsigned int*)growBatchArray(parent, &capacity, sizeof(unsigned int));
+            }
+            runStart[runs] = (unsigned int)(column - base);
+            runEnd[runs] = (unsigned int)(end - base - 1);
+            parent[runs] = (unsigned int)runs;
+            runs++;
+            column = findMazeBit(maze->open, end, base + maze->stride, 1);
+        }
+        
+        // Join overlapping runs of the row above, keeping the smaller root.
+        size_t above = rowRuns[row - 1], here = rowRuns[row];
+        while (above < rowRuns[row] && here < runs) {
+            if (runStart[above] <= runEnd[here] && runStart[here] <= runEnd[above]) {
+                unsigned int a = findRoot(parent, (unsigned int)above), b = findRoot(parent, (unsigned int)here);
+                if (a < b) parent[b] = a;
+                else if (b < a) parent[a] = b;
+            }
+            if (runEnd[above] < runEnd[here]) above++;
+            else here++;
+        }
+    }
+    rowRuns[maze->height + 1] = runs;
+    
+    engine->component = (unsigned int*)calloc(mazeWords(maze) * 64, sizeof(unsigned int));
+    unsigned int* label = (unsigned int*)calloc(runs ? runs : 1, sizeof(unsigned int));
+    if (engine->component == NULL || label == NULL) {
+        printf("Memory allocation failed for maze queries!\n");
+        exit(1);
+    }
+    engine->components = 0;
+    for (int row = 1; row <= maze->height; row++) {
+        unsigned int* cells = engine->component + (size_t)row * maze->stride;
+        for (size_t run = rowRuns[row]; run < rowRuns[row + 1]; run++) {
+            unsigned int root = findRoot(parent, (unsigned int)run);
+            if (label[root] == 0) label[root] = ++engine->components;
+            for (unsigned int column = runStart[run]; column <= runEnd[run]; column++) cells[column] = label[root];
+        }
+    }
+    free(label);
+    free(rowRuns);
+    free(runStart);
+    free(runEnd);
+    free(parent);
+}
+
+void initMazeEngine(MazeEngine* engine, const Maze* maze) {
+    memset(engine, 0, sizeof(MazeEngine));
+    engine->maze = maze;
+    for (int f = 0; f < MAZE_CACHED_FIELDS; f++) engine->fields[f].source = MAZE_NO_CELL;
+    labelMazeComponents(engine);
+}
+
+void freeMazeEngine(MazeEngine* engine) {
+    free(engine->component);
+    for (int f = 0; f < MAZE_CACHED_FIELDS; f++) free(engine->fields[f].distance);
+    memset(engine, 0, sizeof(MazeEngine));
+}
+
+typedef struct {
+    MazeEngine* engine;
+    MazeQuery* queries;
+    long long count;
+    MazeDistanceField* build[MAZE_CACHED_FIELDS];    // fields to compute before answering
+    int builds;
+    int nextBuild;
+    long long nextQuery;
+} MazeBatch;
+
+typedef struct {
+    MazeBatch* batch;
+    long long rejected, fieldHits, searches;
+} MazeBatchWorker;
+
+static int compareCells(const void* a, const void* b) {
+    unsigned int x = *(const unsigned int*)a, y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    unsigned int cell;
+    long long queries;
+} HotEndpoint;
+
+static int compareHotEndpoints(const void* a, const void* b) {
+    const HotEndpoint* x = (const HotEndpoint*)a;
+    const HotEndpoint* y = (const HotEndpoint*)b;
+    if (x->queries != y->queries) return x->queries < y->queries ? 1 : -1;
+    return compareCells(&x->cell, &y->cell);
+}
+
+// Padded cell of p, or MAZE_NO_CELL if it is outside the maze or a wall.
+static unsigned int queryCell(const Maze* maze, MazePoint p) {
+    if (p.x < 0 || p.x >= maze->height || p.y < 0 || p.y >= maze->width) return MAZE_NO_CELL;
+    unsigned int cell = mazeIndex(maze, p.x, p.y);
+    return testMazeBit(maze->open, cell) ? cell : MAZE_NO_CELL;
+}
+
+// Picks the endpoints that need a search in at least
+// MAZE_HOT_SOURCE_QUERIES queries, most used first, and makes sure the
+// cache holds a field for each, evicting the least recently used others.
+static void planDistanceFields(MazeBatch* batch) {
+    MazeEngine* engine = batch->engine;
+    const Maze* maze = engine->maze;
+    unsigned int* endpoints = (unsigned int*)malloc((size_t)(batch->count > 0 ? batch->count : 1) * 2 * sizeof(unsigned int));
+    if (endpoints == NULL) {
+        printf("Memory allocation failed for maze queries!\n");
+        exit(1);
+    }
+    size_t used = 0;
+    for (long long q = 0; q < batch->count; q++) {
+        unsigned int start = queryCell(maze, batch->queries[q].start);
+        unsigned int end = queryCell(maze, batch->queries[q].end);
+        if (start == MAZE_NO_CELL || end == MAZE_NO_CELL || start == end) continue;
+        if (engine->component[start] != engine->component[end]) continue;
+        endpoints[used++] = start;
+        endpoints[used++] = end;
+    }
+    qsort(endpoints, used, sizeof(unsigned int), compareCells);
+    
+    // The busiest MAZE_CACHED_FIELDS endpoints, busiest first.
+    HotEndpoint hot[MAZE_CACHED_FIELDS];
+    int hotCount = 0;
+    for (size_t i = 0; i < used;) {
+        size_t j = i;
+        while (j < used && endpoints[j] == endpoints[i]) j++;
+        HotEndpoint candidate = {endpoints[i], (long long)(j - i)};
+        i = j;
+        if (candidate.queries < MAZE_HOT_SOURCE_QUERIES) continue;
+        if (hotCount < MAZE_CACHED_FIELDS) hot[hotCount++] = candidate;
+        else if (compareHotEndpoints(&candidate, &hot[hotCount - 1]) < 0) hot[hotCount - 1] = candidate;
+        else continue;
+        qsort(hot, (size_t)hotCount, sizeof(HotEndpoint), compareHotEndpoints);
+    }
+    free(endpoints);
+    
+    int wanted[MAZE_CACHED_FIELDS] = {0};
+    int missing[MAZE_CACHED_FIELDS];
+    int missingCount = 0;
+    for (int h = 0; h < hotCount; h++) {
+        int f = 0;
+        while (f < MAZE_CACHED_FIELDS && engine->fields[f].source != hot[h].cell) f++;
+        if (f < MAZE_CACHED_FIELDS) wanted[f] = 1;
+        else missing[missingCount++] = h;
+    }
+    for (int m = 0; m < missingCount; m++) {
+        int victim = -1;
+        for (int f = 0; f < MAZE_CACHED_FIELDS; f++) {
+            if (wanted[f]) continue;
+            if (victim < 0 || engine->fields[f].lastBatch < engine->fields[victim].lastBatch) victim = f;
+        }
+        wanted[victim] = 1;
+        engine->fields[victim].source = hot[missing[m]].cell;
+        batch->build[batch->builds++] = &engine->fields[victim];
+    }
+    for (int f = 0; f < MAZE_CACHED_FIELDS; f++) {
+        if (wanted[f]) engine->fields[f].lastBatch = engine->batches;
+    }
+}
+
+static void answerMazeQuery(MazeBatchWorker* worker, MazeQuery* query) {
+    MazeEngine* engine = worker->batch->engine;
+    const Maze* maze = engine->maze;
+    unsigned int start = queryCell(maze, query->start);
+    unsigned int end = queryCell(maze, query->end);
+    if (start == MAZE_NO_CELL || end == MAZE_NO_CELL || engine->component[start] != engine->component[end]) {
+        query->distance = -1;
+        worker->rejected++;
+        return;
+    }
+    if (start == end) {
+        query->distance = 0;
+        return;
+    }
+    for (int f = 0; f < MAZE_CACHED_FIELDS; f++) {
+        const MazeDistanceField* field = &engine->fields[f];
+        if (field->source == start || field->source == end) {
+            query->distance = field->distance[field->source == start ? end : start];
+            worker->fieldHits++;
+            return;
+        }
+    }
+    
+    // The solvers read start and end from the maze, so search a copy.
+    Maze local = *maze;
+    local.start = query->start;
+    local.end = query->end;
+    MazePath path = {NULL, 0};
+    long long nodes;
+    aStarSolveMaze(&local, &path, &nodes);
+    query->distance = path.length - 1;
+    freeMazePath(&path);
+    worker->searches++;
+}
+
+static void* mazeBatchWorker(void* arg) {
+    MazeBatchWorker* worker = (MazeBatchWorker*)arg;
+    MazeBatch* batch = worker->batch;
+    const Maze* maze = batch->engine->maze;
+    
+    // Fields first, one per thread at a time; nothing reads them until
+    // every thread is done here.
+    int b;
+    while ((b = __atomic_fetch_add(&batch->nextBuild, 1, __ATOMIC_RELAXED)) < batch->builds) {
+        MazeDistanceField* field = batch->build[b];
+        if (field->distance == NULL) {
+            field->distance = (unsigned int*)malloc(mazeWords(maze) * 64 * sizeof(unsigned int));
+            if (field->distance == NULL) {
+                printf("Memory allocation failed for maze queries!\n");
+                exit(1);
+            }
+        }
+        bitsetBfsDistances(maze, field->source, field->distance);
+    }
+    return NULL;
+}
+
+static void* mazeQueryWorker(void* arg) {
+    MazeBatchWorker* worker = (MazeBatchWorker*)arg;
+    MazeBatch* batch = worker->batch;
+    long long q;
+    while ((q = __atomic_fetch_add(&batch->nextQuery, 1, __ATOMIC_RELAXED)) < batch->count) {
+        answerMazeQuery(worker, &batch->queries[q]);
+    }
+    return NULL;
+}
+
+// Runs work on threads workers, the calling thread being the first.
+static void runMazeBatchWorkers(MazeBatchWorker* workers, int threads, void* (*work)(void*)) {
+    pthread_t handles[MAX_MAZE_THREADS];
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, work, &workers[t]) != 0) {
+            printf("Failed to start maze query thread!\n");
+            exit(1);
+        }
+    }
+    work(&workers[0]);
+    for (int t = 1; t < threads; t++) pthread_join(handles[t], NULL);
+}
+
+// Fills in the distance of every query, -1 where the end cannot be
+// reached or either point is a wall or off the maze.
+void answerMazeQueries(MazeEngine* engine, MazeQuery* queries, long long count, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > MAX_MAZE_THREADS) threads = MAX_MAZE_THREADS;
+    
+    MazeBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.engine = engine;
+    batch.queries = queries;
+    batch.count = count;
+    engine->batches++;
+    planDistanceFields(&batch);
+    
+    MazeBatchWorker workers[MAX_MAZE_THREADS];
+    memset(workers, 0, sizeof(workers));
+    for (int t = 0; t < threads; t++) workers[t].batch = &batch;
+    runMazeBatchWorkers(workers, threads < batch.builds ? threads : (batch.builds > 0 ? batch.builds : 1), mazeBatchWorker);
+    runMazeBatchWorkers(workers, threads, mazeQueryWorker);
+    
+    engine->queries += count;
+    engine->fieldsBuilt += batch.builds;
+    for (int t = 0; t < threads; t++) {
+        engine->rejected += workers[t].rejected;
+        engine->fieldHits += workers[t].fieldHits;
+        engine->searches += workers[t].searches;
+    }
+}
+
+// Random open cell; the maze must have one.
+static MazePoint randomOpenCell(const Maze* maze, Rng* rng) {
+    while (1) {
+        MazePoint p = {rngBelow(rng, maze->height), rngBelow(rng, maze->width)};
+        if (testMazeBit(maze->open, mazeIndex(maze, p.x, p.y))) return p;
+    }
+}
+
+void playMazeQueryBatch() {
+    printf("\n=== MAZE BATCH QUERIES ===\n");
+    Maze maze;
+    if (!inputMaze(&maze, 0)) return;
+    char prompt[64];
+    int count = getIntegerInput("Enter number of queries (1-1000000): ", 1, 1000000);
+    int sources = getIntegerInput("Enter distinct start points (1-100000): ", 1, 100000);
+    snprintf(prompt, sizeof(prompt), "Enter worker threads (1-%d): ", MAX_MAZE_THREADS);
+    int threads = getIntegerInput(prompt, 1, MAX_MAZE_THREADS);
+    
+    Rng rng;
+    rngSeed(&rng, (unsigned long long)monotonicNanos());
+    MazePoint* starts = (MazePoint*)malloc((size_t)sources * sizeof(MazePoint));
+    MazeQuery* queries = (MazeQuery*)malloc((size_t)count * sizeof(MazeQuery));
+    if (starts == NULL || queries == NULL) {
+        printf("Memory allocation failed for maze queries!\n");
+        exit(1);
+    }
+    for (int s = 0; s < sources; s++) starts[s] = randomOpenCell(&maze, &rng);
+    for (int q = 0; q < count; q++) {
+        queries[q].start = starts[rngBelow(&rng, sources)];
+        queries[q].end = randomOpenCell(&maze, &rng);
+    }
+    
+    MazeEngine engine;
+    long long start = monotonicNanos();
+    initMazeEngine(&engine, &maze);
+    double labelSeconds = (monotonicNanos() - start) / 1e9;
+    start = monotonicNanos();
+    answerMazeQueries(&engine, queries, count, threads);
+    double querySeconds = (monotonicNanos() - start) / 1e9;
+    
+    long long reachable = 0, totalDistance = 0;
+    for (int q = 0; q < count; q++) {
+        if (queries[q].distance < 0) continue;
+        reachable++;
+        totalDistance += queries[q].distance;
+    }
+    printf("\n%dx%d maze, %u connected components (labelled in %.4f seconds)\n", maze.width, maze.height, engine.components, labelSeconds);
+    printf("Queries: %lld, reachable: %lld, mean distance: %.1f\n", engine.queries, reachable,
+           reachable > 0 ? (double)totalDistance / reachable : 0.0);
+    printf("Rejected by component check: %lld\n", engine.rejected);
+    printf("Answered from %lld cached distance fields: %lld\n", engine.fieldsBuilt, engine.fieldHits);
+    printf("Answered by A* search: %lld\n", engine.searches);
+    printf("Time taken: %.4f seconds (%.0f queries/s)\n", querySeconds, querySeconds > 0 ? count / querySeconds : 0.0);
+    
+    freeMazeEngine(&engine);
+    free(queries);
+    free(starts);
+    freeMaze(&maze);
+}
\ No newline at end of file
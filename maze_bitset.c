@@ -0,0 +1,401 @@
+#include "ai_agent.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(MAZE_NO_SIMD)
+#include <immintrin.h>
+#define MAZE_SIMD_X86 1
+#endif
+
+// Bit-Parallel Breadth-First Search
+// Advances a whole BFS level at once: the next frontier is the current
+// one shifted one cell in each direction, masked by the cells not reached
+// yet. The search works on a copy of the grid cut into 8x8 tiles, one per
+// 64-bit word with bit 8 * row + column, because a BFS wavefront crosses
+// a 64-cell row word in only one or two cells but a tile in about eight.
+// East and west are one-bit shifts within a tile row, north and south
+// eight-bit shifts, plus the edge row or column of the adjacent tile.
+//
+// Only tiles near the frontier are touched. A second bitset, one bit per
+// frontier tile, marks the nonzero tiles; a level visits the tiles whose
+// own bit or a neighbour's is set, in runs along a row of tiles that the
+// kernels walk 4 (AVX2), 2 (SSE2) or 1 tile at a time.
+
+#define TILE_FIRST_COLUMN 0x0101010101010101ULL
+#define TILE_LAST_COLUMN 0x8080808080808080ULL
+
+typedef void (*FrontierKernel)(const unsigned long long* frontier, unsigned long long* next,
+                               unsigned long long* unvisited, unsigned long long* plane,
+                               size_t tileColumns, size_t first, size_t last);
+
+// Cells of tiles first..last reachable in one step from frontier. They
+// are removed from unvisited, stored in next and, if plane is given,
+// added to it.
+static inline void advanceFrontierTile(const unsigned long long* frontier, unsigned long long* next,
+                                       unsigned long long* unvisited, unsigned long long* plane,
+                                       size_t tileColumns, size_t i) {
+    unsigned long long cells = frontier[i];
+    unsigned long long reach = (cells << 1 & ~TILE_FIRST_COLUMN) | (cells >> 1 & ~TILE_LAST_COLUMN) | cells << 8 | cells >> 8 |
+                               (frontier[i - 1] & TILE_LAST_COLUMN) >> 7 | (frontier[i + 1] & TILE_FIRST_COLUMN) << 7 |
+                               frontier[i - tileColumns] >> 56 | frontier[i + tileColumns] << 56;
+    reach &= unvisited[i];
+    unvisited[i] &= ~reach;
+    next[i] = reach;
+    if (plane) plane[i] |= reach;
+}
+
+static void advanceFrontierScalar(const unsigned long long* frontier, unsigned long long* next,
+                                  unsigned long long* unvisited, unsigned long long* plane,
+                                  size_t tileColumns, size_t first, size_t last) {
+    for (size_t i = first; i <= last; i++) advanceFrontierTile(frontier, next, unvisited, plane, tileColumns, i);
+}
+
+#ifdef MAZE_SIMD_X86
+#ifdef __SSE2__
+static void advanceFrontierSse2(const unsigned long long* frontier, unsigned long long* next,
+                                unsigned long long* unvisited, unsigned long long* plane,
+                                size_t tileColumns, size_t first, size_t last) {
+    const __m128i firstColumn = _mm_set1_epi64x((long long)TILE_FIRST_COLUMN);
+    const __m128i lastColumn = _mm_set1_epi64x((long long)TILE_LAST_COLUMN);
+    size_t i = first;
+    for (; i + 1 <= last; i += 2) {
+        __m128i cells = _mm_loadu_si128((const __m128i*)(frontier + i));
+        __m128i west = _mm_loadu_si128((const __m128i*)(frontier + i - 1));
+        __m128i east = _mm_loadu_si128((const __m128i*)(frontier + i + 1));
+        __m128i north = _mm_loadu_si128((const __m128i*)(frontier + i - tileColumns));
+        __m128i south = _mm_loadu_si128((const __m128i*)(frontier + i + tileColumns));
+        __m128i inside = _mm_or_si128(_mm_or_si128(_mm_andnot_si128(firstColumn, _mm_slli_epi64(cells, 1)),
+                                                   _mm_andnot_si128(lastColumn, _mm_srli_epi64(cells, 1))),
+                                      _mm_or_si128(_mm_slli_epi64(cells, 8), _mm_srli_epi64(cells, 8)));
+        __m128i edges = _mm_or_si128(_mm_or_si128(_mm_srli_epi64(_mm_and_si128(west, lastColumn), 7),
+                                                  _mm_slli_epi64(_mm_and_si128(east, firstColumn), 7)),
+                                     _mm_or_si128(_mm_srli_epi64(north, 56), _mm_slli_epi64(south, 56)));
+        __m128i open = _mm_loadu_si128((const __m128i*)(unvisited + i));
+        __m128i reach = _mm_and_si128(_mm_or_si128(inside, edges), open);
+        _mm_storeu_si128((__m128i*)(unvisited + i), _mm_andnot_si128(reach, open));
+        _mm_storeu_si128((__m128i*)(next + i), reach);
+        if (plane) {
+            __m128i* target = (__m128i*)(plane + i);
+            _mm_storeu_si128(target, _mm_or_si128(_mm_loadu_si128(target), reach));
+        }
+    }
+    for (; i <= last; i++) advanceFrontierTile(frontier, next, unvisited, plane, tileColumns, i);
+}
+#endif
+
+__attribute__((target("avx2")))
+static void advanceFrontierAvx2(const unsigned long long* frontier, unsigned long long* next,
+                                unsigned long long* unvisited, unsigned long long* plane,
+                                size_t tileColumns, size_t first, size_t last) {
+    const __m256i firstColumn = _mm256_set1_epi64x((long long)TILE_FIRST_COLUMN);
+    const __m256i lastColumn = _mm256_set1_epi64x((long long)TILE_LAST_COLUMN);
+    size_t i = first;
+    for (; i + 3 <= last; i += 4) {
+        __m256i cells = _mm256_loadu_si256((const __m256i*)(frontier + i));
+        __m256i west = _mm256_loadu_si256((const __m256i*)(frontier + i - 1));
+        __m256i east = _mm256_loadu_si256((const __m256i*)(frontier + i + 1));
+        __m256i north = _mm256_loadu_si256((const __m256i*)(frontier + i - tileColumns));
+        __m256i south = _mm256_loadu_si256((const __m256i*)(frontier + i + tileColumns));
+        __m256i inside = _mm256_or_si256(_mm256_or_si256(_mm256_andnot_si256(firstColumn, _mm256_slli_epi64(cells, 1)),
+                                                         _mm256_andnot_si256(lastColumn, _mm256_srli_epi64(cells, 1))),
+                                         _mm256_or_si256(_mm256_slli_epi64(cells, 8), _mm256_srli_epi64(cells, 8)));
+        __m256i edges = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi64(_mm256_and_si256(west, lastColumn), 7),
+                                                        _mm256_slli_epi64(_mm256_and_si256(east, firstColumn), 7)),
+                                        _mm256_or_si256(_mm256_srli_epi64(north, 56), _mm256_slli_epi64(south, 56)));
+        __m256i open = _mm256_loadu_si256((const __m256i*)(unvisited + i));
+        __m256i reach = _mm256_and_si256(_mm256_or_si256(inside, edges), open);
+        _mm256_storeu_si256((__m256i*)(unvisited + i), _mm256_andnot_si256(reach, open));
+        _mm256_storeu_si256((__m256i*)(next + i), reach);
+        if (plane) {
+            __m256i* target = (__m256i*)(plane + i);
+            _mm256_storeu_si256(target, _mm256_or_si256(_mm256_loadu_si256(target), reach));
+        }
+    }
+    for (; i <= last; i++) advanceFrontierTile(frontier, next, unvisited, plane, tileColumns, i);
+}
+#endif
+
+// The widest kernel this CPU runs.
+static FrontierKernel selectFrontierKernel(const char** name) {
+#ifdef MAZE_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) {
+        if (name) *name = "AVX2";
+        return advanceFrontierAvx2;
+    }
+#ifdef __SSE2__
+    if (name) *name = "SSE2";
+    return advanceFrontierSse2;
+#endif
+#endif
+    if (name) *name = "scalar";
+    return advanceFrontierScalar;
+}
+
+const char* bitsetBfsKernelName() {
+    const char* name;
+    selectFrontierKernel(&name);
+    return name;
+}
+
+// Tile row r (stored at r + 1) holds padded grid rows 8r..8r+7; stored
+// rows 0 and tileRows + 1 stay empty so every tile has four neighbours.
+typedef struct {
+    const Maze* maze;
+    size_t tileColumns, activeWords;  // tiles per row and words per row of the active bitsets
+    int tileRows;
+    unsigned long long* unvisited;    // open cells not reached yet
+    unsigned long long* frontier[2];
+    unsigned long long* active[2];    // bit per frontier tile: set if it may be nonzero
+    int firstRow[2], lastRow[2];      // stored rows holding the frontier, first > last if empty
+    int* firstWord[2];                // per stored row: active words holding the frontier
+    int* lastWord[2];
+    FrontierKernel kernel;
+} BitsetBfs;
+
+static void* callocBitset(size_t words) {
+    void* bits = calloc(words, sizeof(unsigned long long));
+    if (bits == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    return bits;
+}
+
+static inline size_t tileWords(const BitsetBfs* bfs) {
+    return (size_t)(bfs->tileRows + 2) * bfs->tileColumns;
+}
+
+// Tile word and bit of a padded cell index.
+static inline size_t tileOf(const BitsetBfs* bfs, unsigned int cell, int* bit) {
+    unsigned int row = cell / bfs->maze->stride, column = cell % bfs->maze->stride;
+    *bit = (int)(row % 8 * 8 + column % 8);
+    return (size_t)(row / 8 + 1) * bfs->tileColumns + column / 8;
+}
+
+// Padded cell index of bit in the tile at stored row and tile column.
+static inline unsigned int tileCell(const BitsetBfs* bfs, int row, size_t column, int bit) {
+    return (unsigned int)(((size_t)(row - 1) * 8 + bit / 8) * bfs->maze->stride + column * 8 + bit % 8);
+}
+
+static inline int testTileBit(const BitsetBfs* bfs, const unsigned long long* tiles, unsigned int cell) {
+    int bit;
+    size_t tile = tileOf(bfs, cell, &bit);
+    return (int)((tiles[tile] >> bit) & 1);
+}
+
+// Starts a search with source as the whole first frontier.
+static void initBitsetBfs(BitsetBfs* bfs, const Maze* maze, unsigned int source) {
+    size_t rowWords = maze->stride / 64;
+    bfs->maze = maze;
+    bfs->tileColumns = maze->stride / 8;
+    bfs->tileRows = (maze->height + 2 + 7) / 8;
+    bfs->activeWords = (bfs->tileColumns + 63) / 64;
+    bfs->unvisited = (unsigned long long*)callocBitset(tileWords(bfs));
+    for (int k = 0; k < 2; k++) {
+        bfs->frontier[k] = (unsigned long long*)callocBitset(tileWords(bfs));
+        bfs->active[k] = (unsigned long long*)callocBitset((size_t)(bfs->tileRows + 2) * bfs->activeWords);
+        bfs->firstRow[k] = INT_MAX;
+        bfs->lastRow[k] = INT_MIN;
+        bfs->firstWord[k] = (int*)malloc((size_t)(bfs->tileRows + 2) * sizeof(int));
+        bfs->lastWord[k] = (int*)malloc((size_t)(bfs->tileRows + 2) * sizeof(int));
+        if (bfs->firstWord[k] == NULL || bfs->lastWord[k] == NULL) {
+            printf("Memory allocation failed for maze search!\n");
+            exit(1);
+        }
+        for (int row = 0; row < bfs->tileRows + 2; row++) {
+            bfs->firstWord[k][row] = INT_MAX;
+            bfs->lastWord[k][row] = -1;
+        }
+    }
+    bfs->kernel = selectFrontierKernel(NULL);
+    
+    // Byte b of a row word is one row of the b-th tile it covers.
+    for (size_t row = 0; row < (size_t)maze->height + 2; row++) {
+        unsigned long long* tiles = bfs->unvisited + (row / 8 + 1) * bfs->tileColumns;
+        for (size_t w = 0; w < rowWords; w++) {
+            unsigned long long word = maze->open[row * rowWords + w];
+            for (int b = 0; word != 0; b++, word >>= 8) tiles[w * 8 + b] |= (word & 0xFF) << (row % 8 * 8);
+        }
+    }
+    
+    int bit;
+    size_t tile = tileOf(bfs, source, &bit);
+    int row = (int)(tile / bfs->tileColumns);
+    bfs->unvisited[tile] &= ~(1ULL << bit);
+    bfs->frontier[0][tile] |= 1ULL << bit;
+    setMazeBit(bfs->active[0], (unsigned int)(row * bfs->activeWords * 64 + tile % bfs->tileColumns));
+    bfs->firstRow[0] = bfs->lastRow[0] = row;
+    bfs->firstWord[0][row] = bfs->lastWord[0][row] = (int)(tile % bfs->tileColumns / 64);
+}
+
+// Cells reached so far, the source included.
+static long long countBitsetBfsReached(const BitsetBfs* bfs) {
+    long long reached = 0;
+    for (size_t i = 0; i < mazeWords(bfs->maze); i++) reached += __builtin_popcountll(bfs->maze->open[i]);
+    for (size_t i = 0; i < tileWords(bfs); i++) reached -= __builtin_popcountll(bfs->unvisited[i]);
+    return reached;
+}
+
+static void freeBitsetBfs(BitsetBfs* bfs) {
+    free(bfs->unvisited);
+    for (int k = 0; k < 2; k++) {
+        free(bfs->frontier[k]);
+        free(bfs->active[k]);
+        free(bfs->firstWord[k]);
+        free(bfs->lastWord[k]);
+    }
+}
+
+// Replaces frontier[current] by the cells one step beyond it, adding them
+// to plane if given and recording level as their distance if distance is
+// given. Returns 0 once no new cell is reached.
+static int advanceBitsetBfs(BitsetBfs* bfs, int current, unsigned long long* plane, unsigned int* distance, unsigned int level) {
+    const unsigned long long* frontier = bfs->frontier[current];
+    const unsigned long long* active = bfs->active[current];
+    unsigned long long* next = bfs->frontier[!current];
+    unsigned long long* nextActive = bfs->active[!current];
+    const int* firstWord = bfs->firstWord[current];
+    const int* lastWord = bfs->lastWord[current];
+    size_t tileColumns = bfs->tileColumns, activeWords = bfs->activeWords;
+    int firstRow = bfs->firstRow[current] - 1, lastRow = bfs->lastRow[current] + 1;
+    if (firstRow < 1) firstRow = 1;
+    if (lastRow > bfs->tileRows) lastRow = bfs->tileRows;
+    int reached = 0;
+    
+    for (int row = firstRow; row <= lastRow; row++) {
+        const unsigned long long* here = active + (size_t)row * activeWords;
+        const unsigned long long* tiles = next + (size_t)row * tileColumns;
+        unsigned long long* nextRow = nextActive + (size_t)row * activeWords;
+        int rowReached = 0;
+        // Active words of this row and the two beside it, widened by one.
+        int first = firstWord[row - 1], last = lastWord[row - 1];
+        if (firstWord[row] < first) first = firstWord[row];
+        if (firstWord[row + 1] < first) first = firstWord[row + 1];
+        if (lastWord[row] > last) last = lastWord[row];
+        if (lastWord[row + 1] > last) last = lastWord[row + 1];
+        if (first > last) continue;
+        if (first > 0) first--;
+        if (last + 1 < (int)activeWords) last++;
+        
+        for (size_t m = (size_t)first; m <= (size_t)last; m++) {
+            // Tiles next to a frontier tile in the row, or below or above one.
+            unsigned long long candidates = here[m] | here[m] << 1 | here[m] >> 1 |
+                                            (here - activeWords)[m] | (here + activeWords)[m];
+            if (m > 0) candidates |= here[m - 1] >> 63;
+            if (m + 1 < activeWords) candidates |= here[m + 1] << 63;
+            if (m == activeWords - 1 && tileColumns % 64 != 0) candidates &= (1ULL << (tileColumns % 64)) - 1;
+            
+            while (candidates) {
+                int low = __builtin_ctzll(candidates);
+                unsigned long long run = candidates >> low;
+                int length = ~run == 0 ? 64 - low : __builtin_ctzll(~run);
+                candidates &= length + low >= 64 ? 0 : ~0ULL << (length + low);
+                
+                size_t runStart = (size_t)row * tileColumns + m * 64 + low;
+                bfs->kernel(frontier, next, bfs->unvisited, plane, tileColumns, runStart, runStart + length - 1);
+                
+                for (size_t column = m * 64 + low; column < m * 64 + low + length; column++) {
+                    unsigned long long cells = tiles[column];
+                    if (cells == 0) continue;
+                    if (!rowReached) bfs->firstWord[!current][row] = (int)m;
+                    bfs->lastWord[!current][row] = (int)m;
+                    rowReached = 1;
+                    setMazeBit(nextRow, (unsigned int)column);
+                    while (distance && cells) {
+                        distance[tileCell(bfs, row, column, __builtin_ctzll(cells))] = level;
+                        cells &= cells - 1;
+                    }
+                }
+            }
+        }
+        if (rowReached) {
+            if (row < bfs->firstRow[!current]) bfs->firstRow[!current] = row;
+            bfs->lastRow[!current] = row;
+            reached = 1;
+        }
+    }
+    
+    // Retire the old frontier, touching only its nonzero tiles.
+    unsigned long long* old = bfs->frontier[current];
+    unsigned long long* oldActive = bfs->active[current];
+    for (int row = bfs->firstRow[current]; row <= bfs->lastRow[current]; row++) {
+        unsigned long long* bits = oldActive + (size_t)row * activeWords;
+        for (int m = bfs->firstWord[current][row]; m <= bfs->lastWord[current][row]; m++) {
+            while (bits[m]) {
+                old[(size_t)row * tileColumns + (size_t)m * 64 + __builtin_ctzll(bits[m])] = 0;
+                bits[m] &= bits[m] - 1;
+            }
+        }
+        bfs->firstWord[current][row] = INT_MAX;
+        bfs->lastWord[current][row] = -1;
+    }
+    bfs->firstRow[current] = INT_MAX;
+    bfs->lastRow[current] = INT_MIN;
+    return reached;
+}
+
+// Distance of every cell from source in steps, MAZE_NO_CELL where it
+// cannot be reached. distance holds one entry per padded cell
+// (mazeWords(maze) * 64). Returns the number of cells reached.
+long long bitsetBfsDistances(const Maze* maze, unsigned int source, unsigned int* distance) {
+    BitsetBfs bfs;
+    initBitsetBfs(&bfs, maze, source);
+    memset(distance, 0xFF, mazeWords(maze) * 64 * sizeof(unsigned int));
+    distance[source] = 0;
+    
+    int current = 0;
+    for (unsigned int level = 1; advanceBitsetBfs(&bfs, current, NULL, distance, level); level++) current = !current;
+    long long reached = countBitsetBfsReached(&bfs);
+    freeBitsetBfs(&bfs);
+    return reached;
+}
+
+// Shortest path from start to end. Each reached cell's distance mod 3 is
+// kept in two bitplanes (0 in neither, 1 in the first, 2 in the second);
+// neighbouring cells are at most one step apart, so walking back from the
+// end to any reached neighbour one level lower follows a shortest path.
+int bitsetBfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    BitsetBfs bfs;
+    initBitsetBfs(&bfs, maze, startCell);
+    unsigned long long* planes[2] = {(unsigned long long*)callocBitset(tileWords(&bfs)), (unsigned long long*)callocBitset(tileWords(&bfs))};
+    
+    unsigned int level = 0;
+    int current = 0;
+    while (testTileBit(&bfs, bfs.frontier[current], endCell) == 0) {
+        if (!advanceBitsetBfs(&bfs, current, level % 3 == 2 ? NULL : planes[level % 3], NULL, level + 1)) break;
+        current = !current;
+        level++;
+    }
+    
+    int found = testTileBit(&bfs, bfs.frontier[current], endCell);
+    *nodesExplored = countBitsetBfsReached(&bfs);
+    if (found) {
+        path->length = (long long)level + 1;
+        path->cells = (unsigned int*)malloc((size_t)path->length * sizeof(unsigned int));
+        if (path->cells == NULL) {
+            printf("Memory allocation failed for maze path!\n");
+            exit(1);
+        }
+        
+        unsigned int cell = endCell;
+        path->cells[level] = cell;
+        for (unsigned int d = level; d > 0; d--) {
+            unsigned int want = (d - 1) % 3;
+            for (int direction = 0; direction < 4; direction++) {
+                unsigned int neighbour = cell + mazeStep(maze, direction);
+                if (!testMazeBit(maze->open, neighbour) || testTileBit(&bfs, bfs.unvisited, neighbour)) continue;
+                unsigned int residue = (unsigned int)(testTileBit(&bfs, planes[0], neighbour) | testTileBit(&bfs, planes[1], neighbour) << 1);
+                if (residue == want) {
+                    cell = neighbour;
+                    break;
+                }
+            }
+            path->cells[d - 1] = cell;
+        }
+    }
+    
+    freeBitsetBfs(&bfs);
+    free(planes[0]);
+    free(planes[1]);
+    return found;
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "ai_agent.h"
+
+// Differential Checks
+// Separate executable (make check) that runs the maze solvers against
+// each other on seeded random mazes: every solver against BFS, Dijkstra
+// against weighted A*, HPA* for valid paths never cheaper than Dijkstra's,
+// and D* Lite against Dijkstra as walls change under it. Each check
+// prints its case and failure counts; any failure exits with status 1.
+
+#define CHECK_MAZES 40
+#define CHECK_THREADS 3
+#define CHECK_HPA_QUERIES 25
+#define CHECK_REPLANS 40
+#define CHECK_EDITS 8   // cells toggled between replans
+
+static long long checkFailures = 0;
+
+static void reportFailure(const char* check, const char* what, unsigned long long seed) {
+    printf("  FAILED %s: %s (seed %llu)\n", check, what, seed);
+    checkFailures++;
+}
+
+// Mazes of several shapes and generators, weighted when asked.
+static void setUpCheckMaze(Maze* maze, int index, int weighted) {
+    int generator = index % 5;
+    float density = 0.1f + 0.05f * (index % 5);
+    generateSeededMaze(maze, 21 + index % 37, 17 + (index * 7) % 43, generator, density, weighted ? MAZE_MAX_WEIGHT : 1,
+                       1000 + (unsigned long long)index);
+}
+
+// A valid path runs from start to end through open cells, one step at a time.
+static int validMazePath(const Maze* maze, const MazePath* path, MazePoint start, MazePoint end) {
+    if (path->length < 1) return 0;
+    if (path->cells[0] != mazeIndex(maze, start.x, start.y)) return 0;
+    if (path->cells[path->length - 1] != mazeIndex(maze, end.x, end.y)) return 0;
+    for (long long i = 0; i < path->length; i++) {
+        if (!testMazeBit(maze->open, path->cells[i])) return 0;
+        if (i > 0 && mazeManhattan(maze, path->cells[i - 1], path->cells[i]) != 1) return 0;
+    }
+    return 1;
+}
+
+static MazePoint randomOpenCell(const Maze* maze, Rng* rng) {
+    MazePoint point;
+    do {
+        point.x = rngBelow(rng, maze->height);
+        point.y = rngBelow(rng, maze->width);
+    } while (!testMazeBit(maze->open, mazeIndex(maze, point.x, point.y)));
+    return point;
+}
+
+// Every solver finds a path exactly when BFS does, and a valid one. All
+// but DFS and HPA* must match its length; those two must not beat it.
+static void checkSolversAgainstBfs() {
+    int cases = 0;
+    for (int m = 0; m < CHECK_MAZES; m++) {
+        Maze maze;
+        setUpCheckMaze(&maze, m, 0);
+        MazePath expected = {NULL, 0};
+        long long nodes;
+        int reachable = bfsSolveMaze(&maze, &expected, &nodes);
+        
+        for (int solver = 0; solver < mazeSolverCount(); solver++) {
+            const char* name = mazeSolverName(solver);
+            int exact = strcmp(name, "dfs") != 0 && strcmp(name, "hpa") != 0;
+            MazeHierarchy hierarchy;
+            if (mazeSolverUsesHierarchy(solver)) initMazeHierarchy(&hierarchy, &maze, CHECK_THREADS);
+            MazePath path = {NULL, 0};
+            int found = runMazeSolver(solver, &maze, &hierarchy, CHECK_THREADS, &path, &nodes);
+            cases++;
+            if (found != reachable) reportFailure(name, "reachability differs from BFS", 1000 + m);
+            else if (found && !validMazePath(&maze, &path, maze.start, maze.end)) reportFailure(name, "invalid path", 1000 + m);
+            else if (found && (exact ? path.length != expected.length : path.length < expected.length)) {
+                reportFailure(name, "path length differs from BFS", 1000 + m);
+            }
+            freeMazePath(&path);
+            if (mazeSolverUsesHierarchy(solver)) freeMazeHierarchy(&hierarchy);
+        }
+        freeMazePath(&expected);
+        freeMaze(&maze);
+    }
+    printf("solvers against BFS: %d cases\n", cases);
+}
+
+// On weighted mazes Dijkstra and weighted A* must find equally cheap paths.
+static void checkDijkstraAgainstWeightedAStar() {
+    int cases = 0;
+    for (int m = 0; m < CHECK_MAZES; m++) {
+        Maze maze;
+        setUpCheckMaze(&maze, m, 1);
+        MazePath dijkstra = {NULL, 0}, aStar = {NULL, 0};
+        long long nodes;
+        int dijkstraFound = dijkstraSolveMaze(&maze, &dijkstra, &nodes);
+        int aStarFound = weightedAStarSolveMaze(&maze, &aStar, &nodes);
+        cases++;
+        if (dijkstraFound != aStarFound) reportFailure("weighted-astar", "reachability differs from Dijkstra", 1000 + m);
+        else if (aStarFound && !validMazePath(&maze, &aStar, maze.start, maze.end)) {
+            reportFailure("weighted-astar", "invalid path", 1000 + m);
+        } else if (aStarFound && mazePathCost(&maze, &aStar) != mazePathCost(&maze, &dijkstra)) {
+            reportFailure("weighted-astar", "path cost differs from Dijkstra", 1000 + m);
+        }
+        freeMazePath(&dijkstra);
+        freeMazePath(&aStar);
+        freeMaze(&maze);
+    }
+    printf("Dijkstra against weighted A*: %d cases\n", cases);
+}
+
+// HPA* answers random queries on weighted and unweighted mazes with valid
+// paths whose cost it reports correctly and that are never cheaper than
+// Dijkstra's optimum.
+static void checkHierarchy() {
+    int cases = 0;
+    for (int m = 0; m < CHECK_MAZES; m++) {
+        Maze maze;
+        setUpCheckMaze(&maze, m, m % 2);
+        MazeHierarchy hierarchy;
+        initMazeHierarchy(&hierarchy, &maze, CHECK_THREADS);
+        Rng rng;
+        rngSeed(&rng, 1000 + (unsigned long long)m);
+        for (int q = 0; q < CHECK_HPA_QUERIES; q++) {
+            Maze query = maze;
+            query.start = randomOpenCell(&maze, &rng);
+            query.end = randomOpenCell(&maze, &rng);
+            MazePath path = {NULL, 0}, optimal = {NULL, 0};
+            long long nodes;
+            long long cost = queryMazeHierarchy(&hierarchy, query.start, query.end, &path, &nodes);
+            int reachable = dijkstraSolveMaze(&query, &optimal, &nodes);
+            cases++;
+            if ((cost >= 0) != reachable) reportFailure("hpa", "reachability differs from Dijkstra", 1000 + m);
+            else if (reachable && !validMazePath(&maze, &path, query.start, query.end)) reportFailure("hpa", "invalid path", 1000 + m);
+            else if (reachable && cost != mazePathCost(&maze, &path)) reportFailure("hpa", "reported cost is not the path's", 1000 + m);
+            else if (reachable && cost < mazePathCost(&maze, &optimal)) reportFailure("hpa", "cheaper than optimal", 1000 + m);
+            freeMazePath(&path);
+            freeMazePath(&optimal);
+        }
+        freeMazeHierarchy(&hierarchy);
+        freeMaze(&maze);
+    }
+    printf("HPA* against Dijkstra: %d queries\n", cases);
+}
+
+// D* Lite walks its path while cells are toggled around it; after every
+// replan its path must be valid and cost what Dijkstra finds from scratch.
+static void checkPlannerAgainstDijkstra() {
+    int cases = 0;
+    for (int m = 0; m < CHECK_MAZES; m++) {
+        Maze maze;
+        setUpCheckMaze(&maze, m, m % 2);
+        MazePlanner planner;
+        MazePath path = {NULL, 0};
+        long long nodes;
+        initMazePlanner(&planner, &maze);
+        int found = replanMazePath(&planner, &path, &nodes);
+        Rng rng;
+        rngSeed(&rng, 1000 + (unsigned long long)m);
+        for (int round = 0; round < CHECK_REPLANS; round++) {
+            if (found && path.length > 1) moveMazePlannerStart(&planner, mazePointOf(&planner.maze, path.cells[1]));
+            for (int e = 0; e < CHECK_EDITS; e++) {
+                MazePoint point = {rngBelow(&rng, maze.height), rngBelow(&rng, maze.width)};
+                setMazePlannerCell(&planner, point, !testMazeBit(planner.maze.open, mazeIndex(&planner.maze, point.x, point.y)));
+            }
+            freeMazePath(&path);
+            found = replanMazePath(&planner, &path, &nodes);
+            
+            MazePath optimal = {NULL, 0};
+            int reachable = dijkstraSolveMaze(&planner.maze, &optimal, &nodes);
+            cases++;
+            if (found != reachable) reportFailure("dstar", "reachability differs from Dijkstra", 1000 + m);
+            else if (found && !validMazePath(&planner.maze, &path, planner.maze.start, planner.maze.end)) {
+                reportFailure("dstar", "invalid path", 1000 + m);
+            } else if (found && mazePathCost(&planner.maze, &path) != mazePathCost(&planner.maze, &optimal)) {
+                reportFailure("dstar", "path cost differs from Dijkstra", 1000 + m);
+            }
+            freeMazePath(&optimal);
+        }
+        freeMazePath(&path);
+        freeMazePlanner(&planner);
+        freeMaze(&maze);
+    }
+    printf("D* Lite against Dijkstra: %d replans\n", cases);
+}
+
+int main() {
+    checkSolversAgainstBfs();
+    checkDijkstraAgainstWeightedAStar();
+    checkHierarchy();
+    checkPlannerAgainstDijkstra();
+    printf("%lld failures\n", checkFailures);
+    return checkFailures > 0;
+}
\ No newline at end of file
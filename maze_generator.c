@@ -0,0 +1,240 @@
+#include "ai_agent.h"
+
+// Maze Generators
+// Perfect mazes have exactly one path between any two open cells. Rooms
+// are the cells with even row and column; the cells between two rooms are
+// walls until a generator carves the passage. All four generators are
+// driven by a seeded Rng, so a seed always gives the same maze, and keep
+// no more than a few bytes per room besides the maze itself.
+
+typedef struct {
+    Maze* maze;
+    unsigned int rows, columns;     // room grid
+    unsigned int rooms;
+    Rng rng;
+} MazeCarver;
+
+static inline unsigned int roomCell(const MazeCarver* carver, unsigned int room) {
+    return mazeIndex(carver->maze, (int)(room / carver->columns) * 2, (int)(room % carver->columns) * 2);
+}
+
+// Room next to room in direction, MAZE_NO_CELL past the edge of the grid.
+static inline unsigned int adjacentRoom(const MazeCarver* carver, unsigned int room, int direction) {
+    unsigned int column = room % carver->columns;
+    switch (direction) {
+        case 0: return column + 1 < carver->columns ? room + 1 : MAZE_NO_CELL;
+        case 1: return room + carver->columns < carver->rooms ? room + carver->columns : MAZE_NO_CELL;
+        case 2: return column > 0 ? room - 1 : MAZE_NO_CELL;
+        default: return room >= carver->columns ? room - carver->columns : MAZE_NO_CELL;
+    }
+}
+
+static inline int roomCarved(const MazeCarver* carver, unsigned int room) {
+    return testMazeBit(carver->maze->open, roomCell(carver, room));
+}
+
+static inline void carveRoom(MazeCarver* carver, unsigned int room) {
+    setMazeBit(carver->maze->open, roomCell(carver, room));
+}
+
+// Opens the wall between room and its neighbour in direction.
+static inline void carvePassage(MazeCarver* carver, unsigned int room, int direction) {
+    setMazeBit(carver->maze->open, roomCell(carver, room) + mazeStep(carver->maze, direction));
+}
+
+// Directions from room to neighbours that are (carved != 0) or are not
+// carved yet, as a 4-bit mask.
+static int roomNeighbours(const MazeCarver* carver, unsigned int room, int carved) {
+    int mask = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        unsigned int next = adjacentRoom(carver, room, direction);
+        if (next != MAZE_NO_CELL && roomCarved(carver, next) == carved) mask |= 1 << direction;
+    }
+    return mask;
+}
+
+static int randomDirection(MazeCarver* carver, int mask) {
+    int pick = rngBelow(&carver->rng, __builtin_popcount(mask));
+    while (pick--) mask &= mask - 1;
+    return __builtin_ctz(mask);
+}
+
+static void* allocGeneratorArray(size_t count, size_t size) {
+    void* array = calloc(count ? count : 1, size);
+    if (array == NULL) {
+        printf("Memory allocation failed for maze generator!\n");
+        exit(1);
+    }
+    return array;
+}
+
+static inline void setTwoBits(unsigned long long* bits, size_t index, int value) {
+    unsigned long long* word = &bits[index >> 5];
+    int shift = (int)(index & 31) * 2;
+    *word = (*word & ~(3ULL << shift)) | (unsigned long long)value << shift;
+}
+
+static inline int getTwoBits(const unsigned long long* bits, size_t index) {
+    return (int)(bits[index >> 5] >> ((index & 31) * 2)) & 3;
+}
+
+// Recursive backtracker: a random walk that carves into unvisited rooms
+// and backs up when stuck. The explicit stack keeps only the 2-bit
+// direction of each step, which is enough to walk back.
+static void carveBacktracker(MazeCarver* carver) {
+    unsigned long long* steps = (unsigned long long*)allocGeneratorArray(carver->rooms / 32 + 1, sizeof(unsigned long long));
+    unsigned int room = (unsigned int)rngBelow(&carver->rng, (int)carver->rooms);
+    size_t depth = 0;
+    carveRoom(carver, room);
+    
+    while (1) {
+        int open = roomNeighbours(carver, room, 0);
+        if (open) {
+            int direction = randomDirection(carver, open);
+            carvePassage(carver, room, direction);
+            room = adjacentRoom(carver, room, direction);
+            carveRoom(carver, room);
+            setTwoBits(steps, depth++, direction);
+        } else {
+            if (depth == 0) break;
+            room = adjacentRoom(carver, room, (getTwoBits(steps, --depth) + 2) & 3);
+        }
+    }
+    free(steps);
+}
+
+static unsigned int findRoomSet(unsigned int* parent, unsigned int room) {
+    while (parent[room] != room) {
+        parent[room] = parent[parent[room]];
+        room = parent[room];
+    }
+    return room;
+}
+
+// Randomized Kruskal's: every room starts as its own set, and the walls
+// between rooms are knocked down in shuffled order whenever they separate
+// two sets. Edge e is the east (even) or south (odd) wall of room e / 2.
+static void carveKruskal(MazeCarver* carver) {
+    unsigned int* parent = (unsigned int*)allocGeneratorArray(carver->rooms, sizeof(unsigned int));
+    unsigned int* edges = (unsigned int*)allocGeneratorArray((size_t)carver->rooms * 2, sizeof(unsigned int));
+    size_t edgeCount = 0;
+    for (unsigned int room = 0; room < carver->rooms; room++) {
+        parent[room] = room;
+        carveRoom(carver, room);
+        if (adjacentRoom(carver, room, 0) != MAZE_NO_CELL) edges[edgeCount++] = room * 2;
+        if (adjacentRoom(carver, room, 1) != MAZE_NO_CELL) edges[edgeCount++] = room * 2 + 1;
+    }
+    for (size_t i = edgeCount; i > 1; i--) {
+        size_t j = (size_t)rngBelow(&carver->rng, (int)i);
+        unsigned int swap = edges[i - 1];
+        edges[i - 1] = edges[j];
+        edges[j] = swap;
+    }
+    
+    unsigned int joins = 0;
+    for (size_t i = 0; i < edgeCount && joins + 1 < carver->rooms; i++) {
+        unsigned int room = edges[i] / 2;
+        int direction = (int)(edges[i] & 1);
+        unsigned int a = findRoomSet(parent, room);
+        unsigned int b = findRoomSet(parent, adjacentRoom(carver, room, direction));
+        if (a == b) continue;
+        parent[a] = b;
+        carvePassage(carver, room, direction);
+        joins++;
+    }
+    free(edges);
+    free(parent);
+}
+
+// Randomized Prim's: grows one tree by joining a random frontier room
+// (uncarved, next to the tree) to a random carved neighbour.
+static void carvePrim(MazeCarver* carver) {
+    unsigned int* frontier = (unsigned int*)allocGeneratorArray(carver->rooms, sizeof(unsigned int));
+    unsigned long long* queued = (unsigned long long*)allocGeneratorArray(carver->rooms / 64 + 1, sizeof(unsigned long long));
+    size_t size = 0;
+    unsigned int room = (unsigned int)rngBelow(&carver->rng, (int)carver->rooms);
+    
+    while (1) {
+        carveRoom(carver, room);
+        int fresh = roomNeighbours(carver, room, 0);
+        while (fresh) {
+            unsigned int next = adjacentRoom(carver, room, __builtin_ctz(fresh));
+            fresh &= fresh - 1;
+            if (testMazeBit(queued, next)) continue;
+            setMazeBit(queued, next);
+            frontier[size++] = next;
+        }
+        if (size == 0) break;
+        
+        size_t pick = (size_t)rngBelow(&carver->rng, (int)size);
+        room = frontier[pick];
+        frontier[pick] = frontier[--size];
+        carvePassage(carver, room, randomDirection(carver, roomNeighbours(carver, room, 1)));
+    }
+    free(queued);
+    free(frontier);
+}
+
+// Wilson's: loop-erased random walks from each uncarved room until the
+// walk hits the tree, which gives every spanning tree the same chance.
+// Each room remembers only the direction it was last left in, so loops
+// erase themselves: retracing from the walk's start follows the final
+// exits. The first walks are the long ones, before the tree is large.
+static void carveWilson(MazeCarver* carver) {
+    unsigned long long* exits = (unsigned long long*)allocGeneratorArray(carver->rooms / 32 + 1, sizeof(unsigned long long));
+    carveRoom(carver, (unsigned int)rngBelow(&carver->rng, (int)carver->rooms));
+    
+    for (unsigned int first = 0; first < carver->rooms; first++) {
+        if (roomCarved(carver, first)) continue;
+        unsigned int room = first;
+        while (!roomCarved(carver, room)) {
+            int direction;
+            unsigned int next;
+            do {
+                direction = (int)(rngNext(&carver->rng) >> 62);
+                next = adjacentRoom(carver, room, direction);
+            } while (next == MAZE_NO_CELL);
+            setTwoBits(exits, room, direction);
+            room = next;
+        }
+        for (room = first; !roomCarved(carver, room); ) {
+            int direction = getTwoBits(exits, room);
+            carveRoom(carver, room);
+            carvePassage(carver, room, direction);
+            room = adjacentRoom(carver, room, direction);
+        }
+    }
+    free(exits);
+}
+
+// Fills an all-wall maze with a perfect maze by the given generator. Start
+// is the top-left room and end the bottom-right one; with an even width or
+// height the last column or row stays wall.
+void generatePerfectMaze(Maze* maze, int width, int height, int generator, unsigned long long seed) {
+    initMaze(maze, width, height);
+    MazeCarver carver;
+    carver.maze = maze;
+    carver.rows = (unsigned int)(height + 1) / 2;
+    carver.columns = (unsigned int)(width + 1) / 2;
+    carver.rooms = carver.rows * carver.columns;
+    rngSeed(&carver.rng, seed);
+    
+    switch (generator) {
+        case MAZE_GEN_BACKTRACKER: carveBacktracker(&carver); break;
+        case MAZE_GEN_KRUSKAL: carveKruskal(&carver); break;
+        case MAZE_GEN_PRIM: carvePrim(&carver); break;
+        default: carveWilson(&carver); break;
+    }
+    
+    maze->start.x = 0; maze->start.y = 0;
+    maze->end.x = (int)(carver.rows - 1) * 2; maze->end.y = (int)(carver.columns - 1) * 2;
+}
+
+// Any generated maze from its parameters: noise walls at wallDensity or a
+// perfect maze, then terrain up to maxWeight, all from the one seed.
+void generateSeededMaze(Maze* maze, int width, int height, int generator, float wallDensity, int maxWeight,
+                        unsigned long long seed) {
+    if (generator == MAZE_GEN_NOISE) generateMaze(maze, width, height, wallDensity, seed);
+    else generatePerfectMaze(maze, width, height, generator, seed);
+    if (maxWeight > 1) addMazeTerrain(maze, maxWeight, seed);
+}
\ No newline at end of file
@@ -0,0 +1,730 @@
+#include "ai_agent.h"
+
+// Hierarchical Pathfinding
+// HPA* (Botea, Mueller and Schaeffer). The maze is cut into
+// MAZE_CLUSTER_SIZE squares. Wherever two neighbouring clusters share a
+// run of border cells open on both sides, the run gets an entrance, one in
+// its middle or one at each end of a wide run. Each cluster keeps the
+// cheapest way between every two of its entrances, found by searches that
+// stay inside it, as an edge with its cost and its moves, so a query only
+// searches the graph of entrances: a few nodes per cluster instead of a
+// thousand cells. The path found is then laid out from the moves cached
+// with its edges; only the pieces from the start and to the end need a
+// search of their own. Paths only cross borders at entrances, so they can
+// cost a little more than the best one, but never miss one: any crossing
+// can slide along its run to the entrance.
+// A changed cell only dirties its own cluster, plus the neighbour whose
+// shared border it lies on; only dirty clusters are rebuilt, in parallel.
+
+#define CLUSTER_CELLS (MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE)
+#define CLUSTER_BUCKETS (MAZE_MAX_WEIGHT + 1)
+
+typedef struct {
+    MazeHierarchy* hierarchy;
+    int* clusters;              // clusters to build
+    int count;
+    int next;                   // next one to hand out, taken atomically
+} HierarchyBuild;
+
+// Scratch space for building one cluster at a time.
+typedef struct {
+    HierarchyBuild* build;
+    MazeClusterSearch search;
+    unsigned char tree[MAZE_CLUSTER_NODES][CLUSTER_CELLS];     // search->from of the search out of each entrance
+    unsigned int cost[MAZE_CLUSTER_NODES * MAZE_CLUSTER_NODES];
+    unsigned char moves[CLUSTER_CELLS];
+} HierarchyWorker;
+
+typedef struct {
+    int top, left, rows, columns;
+} ClusterBounds;
+
+static ClusterBounds clusterBounds(const MazeHierarchy* hierarchy, int cluster) {
+    ClusterBounds bounds;
+    bounds.top = cluster / hierarchy->clusterColumns * MAZE_CLUSTER_SIZE;
+    bounds.left = cluster % hierarchy->clusterColumns * MAZE_CLUSTER_SIZE;
+    bounds.rows = hierarchy->maze.height - bounds.top < MAZE_CLUSTER_SIZE ? hierarchy->maze.height - bounds.top : MAZE_CLUSTER_SIZE;
+    bounds.columns = hierarchy->maze.width - bounds.left < MAZE_CLUSTER_SIZE ? hierarchy->maze.width - bounds.left : MAZE_CLUSTER_SIZE;
+    return bounds;
+}
+
+static inline int clusterOf(const MazeHierarchy* hierarchy, MazePoint p) {
+    return p.x / MAZE_CLUSTER_SIZE * hierarchy->clusterColumns + p.y / MAZE_CLUSTER_SIZE;
+}
+
+static inline int localCell(const MazeHierarchy* hierarchy, unsigned int cell) {
+    MazePoint p = mazePointOf(&hierarchy->maze, cell);
+    return p.x % MAZE_CLUSTER_SIZE * MAZE_CLUSTER_SIZE + p.y % MAZE_CLUSTER_SIZE;
+}
+
+static inline int localStep(int direction) {
+    return direction == 0 ? 1 : direction == 1 ? MAZE_CLUSTER_SIZE : direction == 2 ? -1 : -MAZE_CLUSTER_SIZE;
+}
+
+// Copies a cluster's walls and weights into search for searchCluster.
+static void loadCluster(const MazeHierarchy* hierarchy, int cluster, MazeClusterSearch* search) {
+    const Maze* maze = &hierarchy->maze;
+    ClusterBounds bounds = clusterBounds(hierarchy, cluster);
+    unsigned long long columns = bounds.columns == 64 ? ~0ULL : (1ULL << bounds.columns) - 1;
+    memset(search->rows, 0, sizeof(search->rows));
+    search->weighted = maze->weight != NULL;
+    for (int r = 0; r < bounds.rows; r++) {
+        // The row's bits straddle at most two words; the padding row below
+        // the maze keeps the second one in range.
+        unsigned int first = mazeIndex(maze, bounds.top + r, bounds.left);
+        unsigned int shift = first & 63;
+        unsigned long long bits = maze->open[first >> 6] >> shift;
+        if (shift != 0) bits |= maze->open[(first >> 6) + 1] << (64 - shift);
+        search->rows[r + 1] = (bits & columns) << 1;
+        if (search->weighted) memcpy(search->weight + r * MAZE_CLUSTER_SIZE, maze->weight + first, (size_t)bounds.columns);
+    }
+}
+
+// Costs from source to the cells of the loaded cluster reachable without
+// leaving it, stopping once every target is settled; only the targets'
+// costs and the moves into settled cells are final. Searching in reverse
+// gives costs from each cell to source instead: stepping onto a cell
+// costs its weight, so the two differ.
+static void searchCluster(const MazeHierarchy* hierarchy, unsigned int source, const unsigned int* targets,
+                          int targetCount, int reverse, MazeClusterSearch* search) {
+    memset(search->dist, 0xFF, sizeof(search->dist));
+    int remaining = 0;
+    for (int t = 0; t < targetCount; t++) {
+        int local = localCell(hierarchy, targets[t]);
+        remaining += !search->goal[local];
+        search->goal[local] = 1;
+    }
+    int local = localCell(hierarchy, source);
+    search->dist[local] = 0;
+    search->entryCell[0] = local;
+    int entries = 1, queued = 1, next = 0;
+    unsigned int key = 0;
+    if (search->weighted) {
+        memset(search->head, 0xFF, sizeof(search->head));
+        search->entryNext[0] = -1;
+        search->head[0] = 0;
+    }
+    
+    while (queued > 0 && remaining > 0) {
+        int current;
+        if (search->weighted) {
+            int* bucket = &search->head[key % CLUSTER_BUCKETS];
+            if (*bucket < 0) {
+                key++;
+                continue;
+            }
+            current = search->entryCell[*bucket];
+            *bucket = search->entryNext[*bucket];
+            queued--;
+            if (search->dist[current] != key) continue;
+        } else {
+            // Breadth-first: entryCell is the queue, each cell on it once.
+            current = search->entryCell[next++];
+            queued--;
+            key = search->dist[current];
+        }
+        if (search->goal[current]) {
+            search->goal[current] = 0;
+            if (--remaining == 0) break;
+        }
+        
+        int row = current / MAZE_CLUSTER_SIZE + 1, column = current % MAZE_CLUSTER_SIZE + 1;
+        int neighbours = (int)((search->rows[row] >> (column + 1)) & 1) | (int)((search->rows[row + 1] >> column) & 1) << 1 |
+                         (int)((search->rows[row] >> (column - 1)) & 1) << 2 | (int)((search->rows[row - 1] >> column) & 1) << 3;
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            int nextLocal = current + localStep(direction);
+            unsigned int nextCost = key + (search->weighted ? search->weight[reverse ? current : nextLocal] : 1);
+            if (nextCost >= search->dist[nextLocal]) continue;
+            search->dist[nextLocal] = nextCost;
+            search->from[nextLocal] = (unsigned char)direction;
+            search->entryCell[entries] = nextLocal;
+            if (search->weighted) {
+                search->entryNext[entries] = search->head[nextCost % CLUSTER_BUCKETS];
+                search->head[nextCost % CLUSTER_BUCKETS] = entries;
+            }
+            entries++;
+            queued++;
+        }
+    }
+    // Targets the search never reached stay unmarked for the next one.
+    if (remaining > 0) {
+        for (int t = 0; t < targetCount; t++) search->goal[localCell(hierarchy, targets[t])] = 0;
+    }
+}
+
+// Entrance cells on the cluster's side of its border in direction, in
+// order along the border. Both clusters of a border find the same runs.
+static int findEntrances(const MazeHierarchy* hierarchy, int cluster, int direction, unsigned int* cells) {
+    const Maze* maze = &hierarchy->maze;
+    ClusterBounds bounds = clusterBounds(hierarchy, cluster);
+    int row = cluster / hierarchy->clusterColumns, column = cluster % hierarchy->clusterColumns;
+    if ((direction == 0 && column + 1 == hierarchy->clusterColumns) || (direction == 1 && row + 1 == hierarchy->clusterRows) ||
+        (direction == 2 && column == 0) || (direction == 3 && row == 0)) return 0;
+    
+    // East and west borders run down a column, south and north along a row.
+    int length = direction % 2 == 0 ? bounds.rows : bounds.columns;
+    unsigned int along = direction % 2 == 0 ? maze->stride : 1;
+    unsigned int first = mazeIndex(maze, bounds.top + (direction == 1 ? bounds.rows - 1 : 0),
+                                   bounds.left + (direction == 0 ? bounds.columns - 1 : 0));
+    int across = mazeStep(maze, direction);
+    int count = 0, run = 0;
+    for (int i = 0; i <= length; i++) {
+        unsigned int cell = first + (unsigned int)i * along;
+        if (i < length && testMazeBit(maze->open, cell) && testMazeBit(maze->open, cell + across)) {
+            run++;
+            continue;
+        }
+        if (run == 0) continue;
+        int runStart = i - run;
+        if (run < MAZE_ENTRANCE_SPLIT) {
+            cells[count++] = first + (unsigned int)(runStart + run / 2) * along;
+        } else {
+            cells[count++] = first + (unsigned int)runStart * along;
+            cells[count++] = first + (unsigned int)(i - 1) * along;
+        }
+        run = 0;
+    }
+    return count;
+}
+
+// Moves from the root of tree (a search's from array) to local cell to,
+// in order; returns how many.
+static int traceMoves(const unsigned char* tree, int root, int to, unsigned char* moves) {
+    int count = 0;
+    for (int local = to; local != root; local -= localStep(tree[local])) moves[count++] = tree[local];
+    for (int i = 0; i < count / 2; i++) {
+        unsigned char swap = moves[i];
+        moves[i] = moves[count - 1 - i];
+        moves[count - 1 - i] = swap;
+    }
+    return count;
+}
+
+static inline int clusterStep(const MazeCluster* cluster, unsigned int step) {
+    return (cluster->steps[step >> 2] >> ((step & 3) * 2)) & 3;
+}
+
+// Appends count moves to the cluster's packed steps, growing them as needed.
+static unsigned int storeMoves(MazeCluster* cluster, unsigned int* used, size_t* capacity, const unsigned char* moves, int count) {
+    if (((size_t)*used + count + 3) / 4 > *capacity) {
+        *capacity = *capacity * 2 > ((size_t)*used + count + 3) / 4 ? *capacity * 2 : ((size_t)*used + count + 3) / 4;
+        cluster->steps = (unsigned char*)realloc(cluster->steps, *capacity);
+        if (cluster->steps == NULL) {
+            printf("Memory allocation failed for maze hierarchy!\n");
+            exit(1);
+        }
+    }
+    unsigned int first = *used;
+    for (int i = 0; i < count; i++, (*used)++) {
+        unsigned int step = *used;
+        if ((step & 3) == 0) cluster->steps[step >> 2] = 0;
+        cluster->steps[step >> 2] |= (unsigned char)(moves[i] << ((step & 3) * 2));
+    }
+    return first;
+}
+
+// Stepping onto a cell costs its weight, so a path costs the same both
+// ways apart from its two ends: from j to i costs what i to j does, less
+// j's weight plus i's. Searching out of entrance i therefore only has to
+// settle the entrances after it, and its tree also gives the moves back.
+static void buildCluster(MazeHierarchy* hierarchy, int index, HierarchyWorker* worker) {
+    const Maze* maze = &hierarchy->maze;
+    MazeCluster* cluster = &hierarchy->clusters[index];
+    MazeClusterSearch* search = &worker->search;
+    cluster->nodes = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        cluster->borderStart[direction] = cluster->nodes;
+        cluster->nodes += findEntrances(hierarchy, index, direction, cluster->cell + cluster->nodes);
+    }
+    cluster->borderStart[4] = cluster->nodes;
+    
+    int nodes = cluster->nodes;
+    unsigned int* cost = worker->cost;
+    loadCluster(hierarchy, index, search);
+    int local[MAZE_CLUSTER_NODES];
+    for (int i = 0; i < nodes; i++) local[i] = localCell(hierarchy, cluster->cell[i]);
+    for (int i = 0; i < nodes; i++) {
+        cost[i * nodes + i] = 0;
+        if (i + 1 == nodes) break;
+        searchCluster(hierarchy, cluster->cell[i], cluster->cell + i + 1, nodes - i - 1, 0, search);
+        memcpy(worker->tree[i], search->from, CLUSTER_CELLS);
+        for (int j = i + 1; j < nodes; j++) {
+            unsigned int forward = search->dist[local[j]];
+            cost[i * nodes + j] = forward;
+            cost[j * nodes + i] = forward == MAZE_NO_CELL ? MAZE_NO_CELL :
+                forward - mazeWeight(maze, cluster->cell[j]) + mazeWeight(maze, cluster->cell[i]);
+        }
+    }
+    
+    // Drop the edges that cost no less than going through another
+    // entrance of the cluster: queries relax far fewer of them, and reach
+    // every node just as cheaply. Only stops that cost something on both
+    // sides count, so two entrances on one corner cell cannot each be
+    // dropped for the other.
+    unsigned char redundant[MAZE_CLUSTER_NODES * MAZE_CLUSTER_NODES];
+    memset(redundant, 0, sizeof(redundant));
+    int edges = 0;
+    for (int i = 0; i < nodes; i++) {
+        for (int j = 0; j < nodes; j++) {
+            unsigned int direct = cost[i * nodes + j];
+            if (i == j || direct == MAZE_NO_CELL) continue;
+            for (int k = 0; k < nodes && !redundant[i * nodes + j]; k++) {
+                unsigned int first = cost[i * nodes + k], second = cost[k * nodes + j];
+                redundant[i * nodes + j] = first != 0 && second != 0 && first != MAZE_NO_CELL && second != MAZE_NO_CELL && first + second == direct;
+            }
+            edges += !redundant[i * nodes + j];
+        }
+    }
+    
+    free(cluster->edges);
+    free(cluster->stepStart);
+    free(cluster->steps);
+    cluster->edges = (MazeClusterEdge*)malloc(((size_t)edges + 1) * sizeof(MazeClusterEdge));
+    cluster->stepStart = (unsigned int*)malloc(((size_t)edges + 1) * sizeof(unsigned int));
+    cluster->steps = NULL;
+    if (cluster->edges == NULL || cluster->stepStart == NULL) {
+        printf("Memory allocation failed for maze hierarchy!\n");
+        exit(1);
+    }
+    unsigned int used = 0;
+    size_t capacity = 0;
+    int e = 0;
+    for (int i = 0; i < nodes; i++) {
+        cluster->edgeStart[i] = e;
+        for (int j = 0; j < nodes; j++) {
+            if (i == j || cost[i * nodes + j] == MAZE_NO_CELL || redundant[i * nodes + j]) continue;
+            MazeClusterEdge* edge = &cluster->edges[e];
+            edge->cost = (unsigned short)cost[i * nodes + j];
+            edge->to = (unsigned short)j;
+            unsigned char* moves = worker->moves;
+            int count;
+            if (i < j) {
+                count = traceMoves(worker->tree[i], local[i], local[j], moves);
+            } else {
+                // Back along the way out of j, each move turned around.
+                count = traceMoves(worker->tree[j], local[j], local[i], moves);
+                for (int m = 0; m < count / 2; m++) {
+                    unsigned char swap = moves[m];
+                    moves[m] = moves[count - 1 - m];
+                    moves[count - 1 - m] = swap;
+                }
+                for (int m = 0; m < count; m++) moves[m] = (moves[m] + 2) & 3;
+            }
+            cluster->stepStart[e++] = storeMoves(cluster, &used, &capacity, moves, count);
+        }
+    }
+    cluster->edgeStart[nodes] = e;
+    cluster->stepStart[e] = used;
+    hierarchy->dirty[index] = 0;
+}
+
+static void* hierarchyBuildWorker(void* arg) {
+    HierarchyWorker* worker = (HierarchyWorker*)arg;
+    HierarchyBuild* build = worker->build;
+    int i;
+    while ((i = __atomic_fetch_add(&build->next, 1, __ATOMIC_RELAXED)) < build->count) {
+        buildCluster(build->hierarchy, build->clusters[i], worker);
+    }
+    return NULL;
+}
+
+// Rebuilds every dirty cluster, one per worker at a time, and returns
+// how many there were. Clusters only write their own entry.
+long long updateMazeHierarchy(MazeHierarchy* hierarchy, int threads) {
+    if (hierarchy->dirtyCount == 0) return 0;
+    int total = hierarchy->clusterRows * hierarchy->clusterColumns;
+    HierarchyBuild build;
+    build.hierarchy = hierarchy;
+    build.clusters = (int*)malloc((size_t)total * sizeof(int));
+    if (build.clusters == NULL) {
+        printf("Memory allocation failed for maze hierarchy!\n");
+        exit(1);
+    }
+    build.count = build.next = 0;
+    for (int c = 0; c < total; c++) {
+        if (hierarchy->dirty[c]) build.clusters[build.count++] = c;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_MAZE_THREADS) threads = MAX_MAZE_THREADS;
+    if (threads > build.count) threads = build.count > 0 ? build.count : 1;
+    
+    HierarchyWorker* workers = (HierarchyWorker*)calloc((size_t)threads, sizeof(HierarchyWorker));
+    if (workers == NULL) {
+        printf("Memory allocation failed for maze hierarchy!\n");
+        exit(1);
+    }
+    pthread_t handles[MAX_MAZE_THREADS];
+    for (int t = 0; t < threads; t++) workers[t].build = &build;
+    // The calling thread works as worker 0.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, hierarchyBuildWorker, &workers[t]) != 0) {
+            printf("Failed to start maze hierarchy thread!\n");
+            exit(1);
+        }
+    }
+    hierarchyBuildWorker(&workers[0]);
+    for (int t = 1; t < threads; t++) pthread_join(handles[t], NULL);
+    
+    free(workers);
+    free(build.clusters);
+    hierarchy->rebuilt += build.count;
+    hierarchy->dirtyCount = 0;
+    return build.count;
+}
+
+// Takes its own copy of maze's walls, like the replanner, and builds
+// every cluster.
+void initMazeHierarchy(MazeHierarchy* hierarchy, const Maze* maze, int threads) {
+    size_t words = mazeWords(maze);
+    hierarchy->maze = *maze;
+    hierarchy->maze.mappedBytes = 0;
+    hierarchy->maze.open = (unsigned long long*)malloc(words * sizeof(unsigned long long));
+    hierarchy->clusterRows = (maze->height + MAZE_CLUSTER_SIZE - 1) / MAZE_CLUSTER_SIZE;
+    hierarchy->clusterColumns = (maze->width + MAZE_CLUSTER_SIZE - 1) / MAZE_CLUSTER_SIZE;
+    size_t clusters = (size_t)hierarchy->clusterRows * hierarchy->clusterColumns;
+    size_t nodes = clusters * MAZE_CLUSTER_NODES + 2;
+    hierarchy->clusters = (MazeCluster*)calloc(clusters, sizeof(MazeCluster));
+    hierarchy->dirty = (unsigned char*)malloc(clusters);
+    hierarchy->node = (MazeHierarchyNode*)calloc(nodes, sizeof(MazeHierarchyNode));
+    hierarchy->search = (MazeClusterSearch*)calloc(2, sizeof(MazeClusterSearch));
+    if (hierarchy->maze.open == NULL || hierarchy->clusters == NULL || hierarchy->dirty == NULL ||
+        hierarchy->node == NULL || hierarchy->search == NULL) {
+        printf("Memory allocation failed for maze hierarchy!\n");
+        exit(1);
+    }
+    memcpy(hierarchy->maze.open, maze->open, words * sizeof(unsigned long long));
+    memset(hierarchy->dirty, 1, clusters);
+    hierarchy->dirtyCount = (int)clusters;
+    hierarchy->generation = 0;
+    hierarchy->rebuilt = 0;
+    initMazeHeap(&hierarchy->heap, nodes);
+    updateMazeHierarchy(hierarchy, threads);
+}
+
+void freeMazeHierarchy(MazeHierarchy* hierarchy) {
+    int clusters = hierarchy->clusterRows * hierarchy->clusterColumns;
+    for (int c = 0; c < clusters; c++) {
+        free(hierarchy->clusters[c].edges);
+        free(hierarchy->clusters[c].stepStart);
+        free(hierarchy->clusters[c].steps);
+    }
+    free(hierarchy->clusters);
+    free(hierarchy->dirty);
+    free(hierarchy->node);
+    free(hierarchy->search);
+    freeMazeHeap(&hierarchy->heap);
+    free(hierarchy->maze.open);
+    hierarchy->maze.open = NULL;
+}
+
+static void markClusterDirty(MazeHierarchy* hierarchy, int cluster) {
+    if (hierarchy->dirty[cluster]) return;
+    hierarchy->dirty[cluster] = 1;
+    hierarchy->dirtyCount++;
+}
+
+// Opens or walls up one cell; the clusters it touches are rebuilt by the
+// next update or query. Returns 0 if point is off the maze.
+int setMazeHierarchyCell(MazeHierarchy* hierarchy, MazePoint point, int open) {
+    Maze* maze = &hierarchy->maze;
+    if (point.x < 0 || point.x >= maze->height || point.y < 0 || point.y >= maze->width) return 0;
+    unsigned int cell = mazeIndex(maze, point.x, point.y);
+    if (testMazeBit(maze->open, cell) == open) return 1;
+    if (open) setMazeBit(maze->open, cell);
+    else clearMazeBit(maze->open, cell);
+    
+    int cluster = clusterOf(hierarchy, point);
+    ClusterBounds bounds = clusterBounds(hierarchy, cluster);
+    markClusterDirty(hierarchy, cluster);
+    if (point.y == bounds.left + bounds.columns - 1 && point.y + 1 < maze->width) markClusterDirty(hierarchy, cluster + 1);
+    if (point.x == bounds.top + bounds.rows - 1 && point.x + 1 < maze->height) markClusterDirty(hierarchy, cluster + hierarchy->clusterColumns);
+    if (point.y == bounds.left && point.y > 0) markClusterDirty(hierarchy, cluster - 1);
+    if (point.x == bounds.top && point.x > 0) markClusterDirty(hierarchy, cluster - hierarchy->clusterColumns);
+    return 1;
+}
+
+// Lowers node's cost in the current query to relaxed, reached from
+// current, if that is cheaper. Entrance costs are at least the Manhattan
+// distance they cover, so the heuristic is consistent and a node popped
+// from the heap is final.
+static inline void relaxNode(MazeHierarchy* hierarchy, unsigned int node, unsigned int nodeCell, unsigned int relaxed,
+                             unsigned int current, unsigned int endCell) {
+    MazeHierarchyNode* state = &hierarchy->node[node];
+    if (state->stamp != hierarchy->generation) {
+        state->stamp = hierarchy->generation;
+        state->estimate = mazeManhattan(&hierarchy->maze, nodeCell, endCell);
+    } else if (relaxed >= state->cost) {
+        return;
+    }
+    state->cost = relaxed;
+    state->parent = current;
+    unsigned long long key = (unsigned long long)(relaxed + state->estimate) << 32;
+    pushMazeHeap(&hierarchy->heap, node, key | (0xFFFFFFFFu - relaxed));
+}
+
+static void appendPathCell(MazePath* path, size_t* capacity, unsigned int cell) {
+    if ((size_t)path->length == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 1024;
+        path->cells = (unsigned int*)realloc(path->cells, *capacity * sizeof(unsigned int));
+        if (path->cells == NULL) {
+            printf("Memory allocation failed for maze path!\n");
+            exit(1);
+        }
+    }
+    path->cells[path->length++] = cell;
+}
+
+// Appends the cells after from up to to, both in the cluster search went
+// out from from.
+static void appendSearchedOut(const MazeHierarchy* hierarchy, const MazeClusterSearch* search, unsigned int from,
+                              unsigned int to, MazePath* path, size_t* capacity) {
+    int steps = 0;
+    for (int local = localCell(hierarchy, to), source = localCell(hierarchy, from); local != source; steps++) {
+        local -= localStep(search->from[local]);
+    }
+    for (int s = 0; s < steps; s++) appendPathCell(path, capacity, to);
+    unsigned int cell = to;
+    for (long long i = path->length - 1; i > path->length - 1 - steps; i--) {
+        path->cells[i] = cell;
+        cell -= mazeStep(&hierarchy->maze, search->from[localCell(hierarchy, cell)]);
+    }
+}
+
+// The same for a search run in reverse from to: its moves lead back.
+static void appendSearchedIn(const MazeHierarchy* hierarchy, const MazeClusterSearch* search, unsigned int from,
+                             unsigned int to, MazePath* path, size_t* capacity) {
+    for (unsigned int cell = from; cell != to; ) {
+        cell -= mazeStep(&hierarchy->maze, search->from[localCell(hierarchy, cell)]);
+        appendPathCell(path, capacity, cell);
+    }
+}
+
+// And for the edge of cluster from entrance i to entrance j.
+static void appendEdge(const MazeHierarchy* hierarchy, const MazeCluster* cluster, int i, int j,
+                       MazePath* path, size_t* capacity) {
+    int e = cluster->edgeStart[i];
+    while (cluster->edges[e].to != j) e++;
+    unsigned int cell = cluster->cell[i];
+    for (unsigned int s = cluster->stepStart[e]; s < cluster->stepStart[e + 1]; s++) {
+        cell += mazeStep(&hierarchy->maze, clusterStep(cluster, s));
+        appendPathCell(path, capacity, cell);
+    }
+}
+
+// Cost of the cheapest path through the entrances from start to end, -1
+// if there is none or either point is a wall or off the maze. Fills path
+// (if not NULL) with the cells; with no path it only finds the cost.
+long long queryMazeHierarchy(MazeHierarchy* hierarchy, MazePoint start, MazePoint end, MazePath* path, long long* nodesExplored) {
+    const Maze* maze = &hierarchy->maze;
+    *nodesExplored = 0;
+    if (path != NULL) {
+        path->cells = NULL;
+        path->length = 0;
+    }
+    if (start.x < 0 || start.x >= maze->height || start.y < 0 || start.y >= maze->width ||
+        end.x < 0 || end.x >= maze->height || end.y < 0 || end.y >= maze->width) return -1;
+    unsigned int startCell = mazeIndex(maze, start.x, start.y), endCell = mazeIndex(maze, end.x, end.y);
+    if (!testMazeBit(maze->open, startCell) || !testMazeBit(maze->open, endCell)) return -1;
+    updateMazeHierarchy(hierarchy, 1);
+    
+    MazeHierarchyNode* node = hierarchy->node;
+    if (++hierarchy->generation == 0) {
+        for (size_t n = 0; n < (size_t)hierarchy->clusterRows * hierarchy->clusterColumns * MAZE_CLUSTER_NODES + 2; n++) node[n].stamp = 0;
+        hierarchy->generation = 1;
+    }
+    unsigned int generation = hierarchy->generation;
+    unsigned int startNode = (unsigned int)(hierarchy->clusterRows * hierarchy->clusterColumns) * MAZE_CLUSTER_NODES;
+    unsigned int endNode = startNode + 1;
+    int startCluster = clusterOf(hierarchy, start), endCluster = clusterOf(hierarchy, end);
+    
+    // Start and end join the graph with edges to the entrances of their
+    // clusters, and to each other if they share one.
+    unsigned int startCost[MAZE_CLUSTER_NODES], endCost[MAZE_CLUSTER_NODES], direct;
+    unsigned int targets[MAZE_CLUSTER_NODES + 1];
+    const MazeCluster* first = &hierarchy->clusters[startCluster];
+    const MazeCluster* last = &hierarchy->clusters[endCluster];
+    MazeClusterSearch* out = &hierarchy->search[0];
+    MazeClusterSearch* in = &hierarchy->search[1];
+    memcpy(targets, first->cell, (size_t)first->nodes * sizeof(unsigned int));
+    targets[first->nodes] = endCell;
+    loadCluster(hierarchy, startCluster, out);
+    searchCluster(hierarchy, startCell, targets, first->nodes + (startCluster == endCluster), 0, out);
+    for (int i = 0; i < first->nodes; i++) startCost[i] = out->dist[localCell(hierarchy, first->cell[i])];
+    direct = startCluster == endCluster ? out->dist[localCell(hierarchy, endCell)] : MAZE_NO_CELL;
+    loadCluster(hierarchy, endCluster, in);
+    searchCluster(hierarchy, endCell, last->cell, last->nodes, 1, in);
+    for (int i = 0; i < last->nodes; i++) endCost[i] = in->dist[localCell(hierarchy, last->cell[i])];
+    
+    MazeHeap* heap = &hierarchy->heap;
+    node[startNode].stamp = generation;
+    node[startNode].cost = 0;
+    node[startNode].parent = startNode;
+    pushMazeHeap(heap, startNode, (unsigned long long)mazeManhattan(maze, startCell, endCell) << 32);
+    
+    while (heap->size > 0) {
+        unsigned int current = popMazeHeap(heap);
+        (*nodesExplored)++;
+        if (current == endNode) break;
+        unsigned int g = node[current].cost;
+        
+        if (current == startNode) {
+            for (int i = 0; i < first->nodes; i++) {
+                if (startCost[i] != MAZE_NO_CELL) relaxNode(hierarchy, (unsigned int)startCluster * MAZE_CLUSTER_NODES + i, first->cell[i], g + startCost[i], current, endCell);
+            }
+            if (direct != MAZE_NO_CELL) relaxNode(hierarchy, endNode, endCell, direct, current, endCell);
+            continue;
+        }
+        
+        int c = (int)(current / MAZE_CLUSTER_NODES), i = (int)(current % MAZE_CLUSTER_NODES);
+        const MazeCluster* cluster = &hierarchy->clusters[c];
+        unsigned int base = (unsigned int)c * MAZE_CLUSTER_NODES;
+        for (int e = cluster->edgeStart[i]; e < cluster->edgeStart[i + 1]; e++) {
+            const MazeClusterEdge* edge = &cluster->edges[e];
+            relaxNode(hierarchy, base + (unsigned int)edge->to, cluster->cell[edge->to], g + edge->cost, current, endCell);
+        }
+        int direction = 0;
+        while (i >= cluster->borderStart[direction + 1]) direction++;
+        int across = direction == 0 ? 1 : direction == 1 ? hierarchy->clusterColumns : direction == 2 ? -1 : -hierarchy->clusterColumns;
+        const MazeCluster* neighbour = &hierarchy->clusters[c + across];
+        int j = neighbour->borderStart[(direction + 2) & 3] + i - cluster->borderStart[direction];
+        relaxNode(hierarchy, (unsigned int)(c + across) * MAZE_CLUSTER_NODES + j, neighbour->cell[j], g + mazeWeight(maze, neighbour->cell[j]), current, endCell);
+        if (c == endCluster && endCost[i] != MAZE_NO_CELL) relaxNode(hierarchy, endNode, endCell, g + endCost[i], current, endCell);
+    }
+    while (heap->size > 0) popMazeHeap(heap);
+    
+    long long total = node[endNode].stamp == generation ? (long long)node[endNode].cost : -1;
+    if (total >= 0 && path != NULL) {
+        // Walk the parents back, then lay out each hop start first.
+        size_t hops = 1, capacity = 0;
+        for (unsigned int n = endNode; n != startNode; n = node[n].parent) hops++;
+        unsigned int* chain = (unsigned int*)malloc(hops * sizeof(unsigned int));
+        if (chain == NULL) {
+            printf("Memory allocation failed for maze path!\n");
+            exit(1);
+        }
+        size_t h = hops;
+        for (unsigned int n = endNode; ; n = node[n].parent) {
+            chain[--h] = n;
+            if (n == startNode) break;
+        }
+        appendPathCell(path, &capacity, startCell);
+        for (size_t k = 1; k < hops; k++) {
+            unsigned int from = chain[k - 1], to = chain[k];
+            unsigned int toCell = to == endNode ? endCell : hierarchy->clusters[to / MAZE_CLUSTER_NODES].cell[to % MAZE_CLUSTER_NODES];
+            if (from == startNode) {
+                appendSearchedOut(hierarchy, out, startCell, toCell, path, &capacity);
+            } else if (to == endNode) {
+                appendSearchedIn(hierarchy, in, hierarchy->clusters[from / MAZE_CLUSTER_NODES].cell[from % MAZE_CLUSTER_NODES], endCell, path, &capacity);
+            } else if (from / MAZE_CLUSTER_NODES != to / MAZE_CLUSTER_NODES) {
+                appendPathCell(path, &capacity, toCell);
+            } else {
+                appendEdge(hierarchy, &hierarchy->clusters[from / MAZE_CLUSTER_NODES], (int)(from % MAZE_CLUSTER_NODES),
+                           (int)(to % MAZE_CLUSTER_NODES), path, &capacity);
+            }
+        }
+        free(chain);
+    }
+    return total;
+}
+
+static MazePoint randomOpenCell(const Maze* maze, Rng* rng) {
+    MazePoint p;
+    do {
+        p.x = rngBelow(rng, maze->height);
+        p.y = rngBelow(rng, maze->width);
+    } while (!testMazeBit(maze->open, mazeIndex(maze, p.x, p.y)));
+    return p;
+}
+
+// Random queries between open cells, each timed with its path and for
+// the cost alone. The first 100 are also solved by weighted A* on the
+// whole maze, to show the speedup and what the entrances cost in path
+// length.
+static void runHierarchyQueries(MazeHierarchy* hierarchy, int queries, Rng* rng) {
+    Maze maze = hierarchy->maze;
+    int checked = queries < 100 ? queries : 100;
+    double hierarchySeconds = 0, costSeconds = 0, checkSeconds = 0, costRatio = 0;
+    long long hierarchyNodes = 0, checkNodes = 0, found = 0, compared = 0, mismatches = 0;
+    for (int q = 0; q < queries; q++) {
+        maze.start = randomOpenCell(&maze, rng);
+        maze.end = randomOpenCell(&maze, rng);
+        MazePath path = {NULL, 0};
+        long long nodes;
+        long long start = monotonicNanos();
+        long long cost = queryMazeHierarchy(hierarchy, maze.start, maze.end, &path, &nodes);
+        hierarchySeconds += (monotonicNanos() - start) / 1e9;
+        start = monotonicNanos();
+        if (queryMazeHierarchy(hierarchy, maze.start, maze.end, NULL, &nodes) != cost) mismatches++;
+        costSeconds += (monotonicNanos() - start) / 1e9;
+        hierarchyNodes += nodes;
+        found += cost >= 0;
+        if (cost >= 0 && mazePathCost(&maze, &path) != cost) mismatches++;
+        freeMazePath(&path);
+        if (q >= checked) continue;
+        
+        start = monotonicNanos();
+        int reachable = weightedAStarSolveMaze(&maze, &path, &nodes);
+        checkSeconds += (monotonicNanos() - start) / 1e9;
+        checkNodes += nodes;
+        if (reachable != (cost >= 0)) mismatches++;
+        else if (reachable) {
+            costRatio += mazePathCost(&maze, &path) > 0 ? (double)cost / mazePathCost(&maze, &path) : 1;
+            compared++;
+        }
+        freeMazePath(&path);
+    }
+    printf("%d queries, %lld with a path\n", queries, found);
+    printf("HPA*: %.6f seconds and %lld nodes per query\n", hierarchySeconds / queries, hierarchyNodes / queries);
+    printf("HPA* cost alone, no path: %.6f seconds per query\n", costSeconds / queries);
+    printf("Weighted A* on the full maze: %.6f seconds and %lld nodes per query\n", checkSeconds / checked, checkNodes / checked);
+    printf("HPA* path cost over the best, first %d queries: %.4f\n", checked, compared > 0 ? costRatio / compared : 1.0);
+    printf("Queries that disagree: %lld\n", mismatches);
+}
+
+void playMazeHierarchy() {
+    printf("\n=== MAZE HIERARCHICAL QUERIES ===\n");
+    Maze maze;
+    if (!inputMaze(&maze, 1)) return;
+    char prompt[64];
+    snprintf(prompt, sizeof(prompt), "Enter worker threads (1-%d): ", MAX_MAZE_THREADS);
+    int threads = getIntegerInput(prompt, 1, MAX_MAZE_THREADS);
+    int queries = getIntegerInput("Enter random queries (1-100000): ", 1, 100000);
+    int changes = getIntegerInput("Enter cells changed between rounds (0-100000): ", 0, 100000);
+    if (!testMazeBit(maze.open, mazeIndex(&maze, maze.start.x, maze.start.y))) {
+        printf("The maze has no open cells!\n");
+        freeMaze(&maze);
+        return;
+    }
+    
+    MazeHierarchy hierarchy;
+    long long start = monotonicNanos();
+    initMazeHierarchy(&hierarchy, &maze, threads);
+    long long entrances = 0;
+    for (int c = 0; c < hierarchy.clusterRows * hierarchy.clusterColumns; c++) entrances += hierarchy.clusters[c].nodes;
+    printf("\n%d x %d clusters, %lld entrances, built in %.4f seconds\n", hierarchy.clusterRows, hierarchy.clusterColumns,
+           entrances, (monotonicNanos() - start) / 1e9);
+    
+    Rng rng;
+    rngSeed(&rng, (unsigned long long)monotonicNanos());
+    runHierarchyQueries(&hierarchy, queries, &rng);
+    
+    if (changes > 0) {
+        // Walls only go up away from the start cell, so it stays open for
+        // randomOpenCell to find.
+        unsigned int keep = mazeIndex(&maze, maze.start.x, maze.start.y);
+        for (int c = 0; c < changes; c++) {
+            MazePoint p = {rngBelow(&rng, maze.height), rngBelow(&rng, maze.width)};
+            unsigned int cell = mazeIndex(&maze, p.x, p.y);
+            if (cell != keep) setMazeHierarchyCell(&hierarchy, p, !testMazeBit(hierarchy.maze.open, cell));
+        }
+        start = monotonicNanos();
+        long long rebuilt = updateMazeHierarchy(&hierarchy, threads);
+        printf("\n%d cells changed: %lld clusters rebuilt in %.4f seconds\n", changes, rebuilt, (monotonicNanos() - start) / 1e9);
+        runHierarchyQueries(&hierarchy, queries, &rng);
+    }
+    
+    freeMazeHierarchy(&hierarchy);
+    freeMaze(&maze);
+}
\ No newline at end of file
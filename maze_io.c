@@ -0,0 +1,325 @@
+#include "ai_agent.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Maze Files
+// Binary maze files hold the padded bitset (and weights) as the solvers
+// use it, so loading one maps the file read-only and points maze->open
+// into the mapping: no parse and no copy, and processes loading the same
+// file share its pages. Loading still validates the whole file once (see
+// mapMazeFile), so every page is read at load time. Text mazes use the
+// notation printMaze draws ('#' wall, ' ' open, a digit for an open cell
+// of that weight, 'S' start, 'E' end) and are parsed in fixed-size
+// chunks, so only the grid they become has to fit in memory. Load errors
+// go to stderr, so a batch run's records on stdout stay machine-readable.
+
+static const char mazeFileMagic[8] = "AIMAZE1";
+
+int writeMazeFile(const Maze* maze, const char* path) {
+    MazeFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, mazeFileMagic, sizeof(header.magic));
+    header.width = maze->width;
+    header.height = maze->height;
+    header.start = maze->start;
+    header.end = maze->end;
+    header.stride = maze->stride;
+    header.weighted = maze->weight != NULL;
+    
+    size_t words = mazeWords(maze);
+    FilePart parts[] = {
+        {&header, sizeof(header)},
+        {maze->open, words * sizeof(unsigned long long)},
+        {maze->weight, maze->weight != NULL ? words * 64 : 0},
+    };
+    return writeFileAtomically(path, parts, 3);
+}
+
+static int mazePointInside(const Maze* maze, MazePoint p) {
+    return p.x >= 0 && p.x < maze->height && p.y >= 0 && p.y < maze->width;
+}
+
+// The padding rows and the padding columns of every row must be walls:
+// they are what keeps every neighbour read in range and every path cell
+// inside the grid. Weights must all be 1 to MAZE_MAX_WEIGHT, which the
+// bucket queues of the weighted solvers index by. The solvers check
+// neither, so a damaged file would read or write out of bounds, and the
+// check is one full pass at load rather than lazy. The column check reads
+// the first and last word of each row, which for any maze under ~32k
+// cells wide touches every page of the bitset; the weight check reads
+// every weight byte, 64 times the bitset's size.
+int mapMazeFile(Maze* maze, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open %s!\n", path);
+        return 0;
+    }
+    
+    struct stat st;
+    MazeFileHeader header;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header) ||
+        read(fd, &header, sizeof(header)) != (ssize_t)sizeof(header) ||
+        memcmp(header.magic, mazeFileMagic, sizeof(header.magic)) != 0 ||
+        header.width < 1 || header.width > MAX_MAZE_SIZE ||
+        header.height < 1 || header.height > MAX_MAZE_SIZE || header.weighted > 1) {
+        fprintf(stderr, "%s is not a maze file!\n", path);
+        close(fd);
+        return 0;
+    }
+    maze->width = header.width;
+    maze->height = header.height;
+    maze->stride = (unsigned int)(header.width + 2 + 63) / 64 * 64;
+    maze->start = header.start;
+    maze->end = header.end;
+    
+    size_t bytes = sizeof(header) + mazeWords(maze) * (sizeof(unsigned long long) + (header.weighted ? 64 : 0));
+    if (header.stride != maze->stride || (size_t)st.st_size != bytes ||
+        !mazePointInside(maze, maze->start) || !mazePointInside(maze, maze->end)) {
+        fprintf(stderr, "%s is damaged!\n", path);
+        close(fd);
+        return 0;
+    }
+    
+    void* mapped = mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        fprintf(stderr, "Cannot map %s!\n", path);
+        return 0;
+    }
+    maze->open = (unsigned long long*)((char*)mapped + sizeof(header));
+    maze->weight = header.weighted ? (unsigned char*)(maze->open + mazeWords(maze)) : NULL;
+    maze->mappedBytes = bytes;
+    
+    size_t rowWords = maze->stride / 64;
+    int sealed = testMazeBit(maze->open, mazeIndex(maze, maze->start.x, maze->start.y)) &&
+                 testMazeBit(maze->open, mazeIndex(maze, maze->end.x, maze->end.y));
+    for (size_t w = 0; w < rowWords; w++) {
+        if (maze->open[w] != 0 || maze->open[mazeWords(maze) - rowWords + w] != 0) sealed = 0;
+    }
+    // Bits width + 1 and up are padding; they always end in the last word.
+    size_t lastWord = (size_t)(maze->width + 1) / 64;
+    unsigned long long tailMask = ~0ULL << ((maze->width + 1) % 64);
+    for (int i = 1; i <= maze->height && sealed; i++) {
+        const unsigned long long* row = maze->open + (size_t)i * rowWords;
+        if ((row[0] & 1) != 0 || (row[lastWord] & tailMask) != 0) sealed = 0;
+    }
+    if (maze->weight != NULL) {
+        size_t cells = mazeWords(maze) * 64;
+        unsigned char outOfRange = 0;
+        for (size_t c = 0; c < cells; c++) outOfRange |= (unsigned char)(maze->weight[c] - 1) >= MAZE_MAX_WEIGHT;
+        if (outOfRange) sealed = 0;
+    }
+    if (!sealed) {
+        fprintf(stderr, "%s is damaged!\n", path);
+        freeMaze(maze);
+        return 0;
+    }
+    return 1;
+}
+
+// Streaming state for readMazeText.
+typedef struct {
+    Maze* maze;
+    unsigned long long row[(MAX_MAZE_SIZE + 2 + 63) / 64];   // the row being read, cell y at bit y + 1
+    unsigned char rowWeight[MAX_MAZE_SIZE + 2];             // and its weights, cell y at y + 1
+    size_t capacity;            // words allocated for maze->open; maze->weight has 64 bytes per word
+    int column, line;
+    int starts, ends;
+} MazeTextReader;
+
+static void addTextCell(MazeTextReader* reader, int open) {
+    if (open) setMazeBit(reader->row, (unsigned int)reader->column + 1);
+    reader->column++;
+}
+
+// Weights are only stored once a cell heavier than 1 turns up; every cell
+// before it weighs 1.
+static void addWeightedTextCell(MazeTextReader* reader, int weight) {
+    Maze* maze = reader->maze;
+    if (maze->weight == NULL && weight > 1) {
+        maze->weight = (unsigned char*)malloc(reader->capacity * 64 + 1);
+        if (maze->weight == NULL) {
+            printf("Memory allocation failed for maze!\n");
+            exit(1);
+        }
+        memset(maze->weight, 1, reader->capacity * 64);
+    }
+    reader->rowWeight[reader->column + 1] = (unsigned char)weight;
+    addTextCell(reader, 1);
+}
+
+// Appends the row just read below the others; the first row sets the
+// width. Storage doubles as rows arrive and new words start as wall, so
+// the bottom padding row is already in place when the text ends.
+static int finishTextRow(MazeTextReader* reader) {
+    Maze* maze = reader->maze;
+    if (maze->height == 0) {
+        maze->width = reader->column;
+        maze->stride = (unsigned int)(maze->width + 2 + 63) / 64 * 64;
+    } else if (reader->column != maze->width) {
+        fprintf(stderr, "Line %d has %d cells; the maze is %d wide!\n", reader->line, reader->column, maze->width);
+        return 0;
+    }
+    if (maze->height == MAX_MAZE_SIZE) {
+        fprintf(stderr, "Mazes are at most %d rows high!\n", MAX_MAZE_SIZE);
+        return 0;
+    }
+    
+    size_t rowWords = maze->stride / 64;
+    size_t needed = (size_t)(maze->height + 3) * rowWords;
+    if (needed > reader->capacity) {
+        size_t grown = reader->capacity * 2 > needed ? reader->capacity * 2 : needed;
+        maze->open = (unsigned long long*)realloc(maze->open, grown * sizeof(unsigned long long));
+        if (maze->open == NULL) {
+            printf("Memory allocation failed for maze!\n");
+            exit(1);
+        }
+        memset(maze->open + reader->capacity, 0, (grown - reader->capacity) * sizeof(unsigned long long));
+        if (maze->weight != NULL) {
+            maze->weight = (unsigned char*)realloc(maze->weight, grown * 64);
+            if (maze->weight == NULL) {
+                printf("Memory allocation failed for maze!\n");
+                exit(1);
+            }
+            memset(maze->weight + reader->capacity * 64, 1, (grown - reader->capacity) * 64);
+        }
+        reader->capacity = grown;
+    }
+    memcpy(maze->open + (size_t)(maze->height + 1) * rowWords, reader->row, rowWords * sizeof(unsigned long long));
+    memset(reader->row, 0, rowWords * sizeof(unsigned long long));
+    if (maze->weight != NULL) memcpy(maze->weight + (size_t)(maze->height + 1) * maze->stride, reader->rowWeight, maze->stride);
+    memset(reader->rowWeight, 1, sizeof(reader->rowWeight));
+    maze->height++;
+    return 1;
+}
+
+// Reads a text maze. Lines starting with '+' and '|' borders, as printMaze
+// draws them, are skipped, so are blank lines, and path marks ('.' or
+// '·') count as open cells of weight 1.
+int readMazeText(Maze* maze, FILE* file) {
+    MazeTextReader* reader = (MazeTextReader*)calloc(1, sizeof(MazeTextReader));
+    if (reader == NULL) {
+        printf("Memory allocation failed for maze!\n");
+        exit(1);
+    }
+    reader->maze = maze;
+    reader->line = 1;
+    memset(reader->rowWeight, 1, sizeof(reader->rowWeight));
+    maze->open = NULL;
+    maze->weight = NULL;
+    maze->width = maze->height = 0;
+    maze->stride = 0;
+    maze->mappedBytes = 0;
+    
+    unsigned char buffer[65536];
+    size_t got;
+    int ok = 1, border = 0, lead = 0;   // border: skip to the end of the line; lead: saw 0xC2 of '·'
+    while (ok && (got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; ok && i < got; i++) {
+            unsigned char c = buffer[i];
+            if (c == '\n') {
+                if (reader->column > 0) ok = finishTextRow(reader);
+                reader->column = 0;
+                reader->line++;
+                border = lead = 0;
+                continue;
+            }
+            if (border || c == '\r' || c == '|') continue;
+            if (lead) {
+                lead = 0;
+                if (c == 0xB7) {
+                    c = '.';
+                } else {
+                    fprintf(stderr, "Line %d: unexpected character!\n", reader->line);
+                    ok = 0;
+                    break;
+                }
+            }
+            int limit = maze->height == 0 ? MAX_MAZE_SIZE : maze->width;
+            if (c != '+' && c != 0xC2 && reader->column == limit) {
+                fprintf(stderr, "Line %d has more than %d cells!\n", reader->line, limit);
+                ok = 0;
+                break;
+            }
+            switch (c) {
+                case '+':
+                    if (reader->column > 0) {
+                        fprintf(stderr, "Line %d: unexpected '+'!\n", reader->line);
+                        ok = 0;
+                    }
+                    border = 1;
+                    break;
+                case 0xC2: lead = 1; break;
+                case '#': addTextCell(reader, 0); break;
+                case ' ':
+                case '.': addTextCell(reader, 1); break;
+                case '1': case '2': case '3': case '4': case '5':
+                case '6': case '7': case '8': case '9':
+                    addWeightedTextCell(reader, c - '0');
+                    break;
+                case 'S':
+                    maze->start.x = maze->height;
+                    maze->start.y = reader->column;
+                    reader->starts++;
+                    addTextCell(reader, 1);
+                    break;
+                case 'E':
+                    maze->end.x = maze->height;
+                    maze->end.y = reader->column;
+                    reader->ends++;
+                    addTextCell(reader, 1);
+                    break;
+                default:
+                    fprintf(stderr, "Line %d: unexpected character '%c'!\n", reader->line, c);
+                    ok = 0;
+                    break;
+            }
+        }
+    }
+    if (ok && reader->column > 0) ok = finishTextRow(reader);
+    if (ok && ferror(file)) {
+        fprintf(stderr, "Error reading maze text!\n");
+        ok = 0;
+    }
+    if (ok && (maze->height == 0 || reader->starts != 1 || reader->ends != 1)) {
+        fprintf(stderr, "A maze needs at least one row and exactly one S and one E!\n");
+        ok = 0;
+    }
+    free(reader);
+    
+    if (!ok) {
+        free(maze->open);
+        free(maze->weight);
+        maze->open = NULL;
+        maze->weight = NULL;
+        return 0;
+    }
+    // Give back what the last doubling over-allocated.
+    unsigned long long* trimmed = (unsigned long long*)realloc(maze->open, mazeWords(maze) * sizeof(unsigned long long));
+    if (trimmed != NULL) maze->open = trimmed;
+    if (maze->weight != NULL) {
+        unsigned char* trimmedWeight = (unsigned char*)realloc(maze->weight, mazeWords(maze) * 64);
+        if (trimmedWeight != NULL) maze->weight = trimmedWeight;
+    }
+    return 1;
+}
+
+// Maps a binary maze file, or parses anything else as a text maze.
+int loadMaze(Maze* maze, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s!\n", path);
+        return 0;
+    }
+    char magic[8];
+    if (fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, mazeFileMagic, sizeof(magic)) == 0) {
+        fclose(file);
+        return mapMazeFile(maze, path);
+    }
+    rewind(file);
+    int ok = readMazeText(maze, file);
+    fclose(file);
+    return ok;
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "ai_agent.h"
+
+// Parallel Breadth-First Search
+// Level-synchronous BFS that gives exactly the parents and node count of
+// bfsSolveMaze. The queue BFS hands each cell to the neighbour that is
+// dequeued first, which is its neighbour with the lowest position in the
+// previous level. Each level is split into consecutive ranges of
+// positions, one per thread, and runs in two phases separated by barriers:
+//   1. claim: each thread marks the unvisited neighbours of its cells,
+//      and a cell keeps the mark of the lowest thread (an atomic max);
+//   2. collect: each thread walks its cells in order again and takes the
+//      neighbours it kept that are still unvisited, marking them visited
+//      and appending them to its share of the next level.
+// Within a thread the earlier cell takes a neighbour first, so every cell
+// goes to the same parent as in the queue BFS. Concatenating the shares in
+// thread order reproduces the queue order, so the next level is never
+// copied. A single thread needs no claim phase.
+
+typedef struct {
+    unsigned int* cells[2];     // this thread's share of a level, by level parity
+    size_t size[2], capacity[2];
+    long long endIndex;         // where the end cell is in the share just collected, -1 if absent
+} ParallelBfsShare;
+
+typedef struct {
+    const Maze* maze;
+    MazeSearch search;
+    unsigned char* claim;       // per cell: threads - index of the lowest claiming thread, 0 if none
+    unsigned int endCell;
+    int threads;
+    pthread_barrier_t barrier;
+    ParallelBfsShare shares[MAX_MAZE_THREADS];
+    int found;
+    long long nodes;
+} ParallelBfs;
+
+typedef struct {
+    ParallelBfs* bfs;
+    int index;
+} ParallelBfsWorker;
+
+// mazeNeighbours for a bitset other threads are clearing bits in.
+static inline int sharedMazeNeighbours(const unsigned long long* bits, unsigned int cell, unsigned int stride) {
+    unsigned int word = cell >> 6, bit = cell & 63, rowWords = stride >> 6;
+    unsigned long long row = __atomic_load_n(&bits[word], __ATOMIC_RELAXED);
+    int east = (int)(bit < 63 ? (row >> (bit + 1)) & 1 : __atomic_load_n(&bits[word + 1], __ATOMIC_RELAXED) & 1);
+    int west = (int)(bit > 0 ? (row >> (bit - 1)) & 1 : __atomic_load_n(&bits[word - 1], __ATOMIC_RELAXED) >> 63);
+    int south = (int)((__atomic_load_n(&bits[word + rowWords], __ATOMIC_RELAXED) >> bit) & 1);
+    int north = (int)((__atomic_load_n(&bits[word - rowWords], __ATOMIC_RELAXED) >> bit) & 1);
+    return east | south << 1 | west << 2 | north << 3;
+}
+
+static void pushShareCell(ParallelBfsShare* share, int parity, unsigned int cell) {
+    if (share->size[parity] == share->capacity[parity]) {
+        share->capacity[parity] = share->capacity[parity] ? share->capacity[parity] * 2 : 1024;
+        share->cells[parity] = (unsigned int*)realloc(share->cells[parity], share->capacity[parity] * sizeof(unsigned int));
+        if (share->cells[parity] == NULL) {
+            printf("Memory allocation failed for maze frontier!\n");
+            exit(1);
+        }
+    }
+    share->cells[parity][share->size[parity]++] = cell;
+}
+
+// Cell at position in the level, given where each share starts. share is
+// the share the previous position was in and is advanced as needed.
+static inline unsigned int levelCell(const ParallelBfs* bfs, int parity, const size_t* offset, int* share, size_t position) {
+    while (position >= offset[*share] + bfs->shares[*share].size[parity]) (*share)++;
+    return bfs->shares[*share].cells[parity][position - offset[*share]];
+}
+
+static void* parallelBfsWorker(void* arg) {
+    ParallelBfsWorker* worker = (ParallelBfsWorker*)arg;
+    ParallelBfs* bfs = worker->bfs;
+    const Maze* maze = bfs->maze;
+    ParallelBfsShare* mine = &bfs->shares[worker->index];
+    int threads = bfs->threads;
+    int parity = 0;
+    long long processed = 0;
+    
+    while (1) {
+        size_t offset[MAX_MAZE_THREADS], total = 0;
+        for (int s = 0; s < threads; s++) {
+            offset[s] = total;
+            total += bfs->shares[s].size[parity];
+        }
+        size_t first = total * worker->index / threads;
+        size_t last = total * (worker->index + 1) / threads;
+        
+        unsigned char mark = (unsigned char)(threads - worker->index);
+        int share = 0;
+        if (threads > 1) {
+            // Claim: unvisited is only read here, so plain loads are fine.
+            for (size_t position = first; position < last; position++) {
+                unsigned int cell = levelCell(bfs, parity, offset, &share, position);
+                int neighbours = mazeNeighbours(bfs->search.unvisited, cell, maze->stride);
+                while (neighbours) {
+                    int direction = __builtin_ctz(neighbours);
+                    neighbours &= neighbours - 1;
+                    unsigned char* slot = &bfs->claim[cell + mazeStep(maze, direction)];
+                    unsigned char seen = __atomic_load_n(slot, __ATOMIC_RELAXED);
+                    while (mark > seen && !__atomic_compare_exchange_n(slot, &seen, mark, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+                }
+            }
+            pthread_barrier_wait(&bfs->barrier);
+        }
+        
+        // Collect. Other threads clear only cells they kept, never one of
+        // ours, so the neighbour masks here do not depend on timing.
+        mine->size[!parity] = 0;
+        mine->endIndex = -1;
+        share = 0;
+        for (size_t position = first; position < last; position++) {
+            unsigned int cell = levelCell(bfs, parity, offset, &share, position);
+            int neighbours = threads > 1 ? sharedMazeNeighbours(bfs->search.unvisited, cell, maze->stride)
+                                         : mazeNeighbours(bfs->search.unvisited, cell, maze->stride);
+            while (neighbours) {
+                int direction = __builtin_ctz(neighbours);
+                neighbours &= neighbours - 1;
+                unsigned int next = cell + mazeStep(maze, direction);
+                if (threads == 1) {
+                    reachMazeCell(&bfs->search, next, direction);
+                } else {
+                    if (bfs->claim[next] != mark) continue;
+                    __atomic_fetch_and(&bfs->search.unvisited[next >> 6], ~(1ULL << (next & 63)), __ATOMIC_RELAXED);
+                    __atomic_fetch_or(&bfs->search.parentDir[next >> 5], (unsigned long long)direction << ((next & 31) * 2), __ATOMIC_RELAXED);
+                }
+                if (next == bfs->endCell) mine->endIndex = (long long)mine->size[!parity];
+                pushShareCell(mine, !parity, next);
+            }
+        }
+        pthread_barrier_wait(&bfs->barrier);
+        
+        // Every thread reaches the same verdict from the shares.
+        processed += (long long)total;
+        size_t nextTotal = 0;
+        long long endPosition = -1;
+        for (int s = 0; s < threads; s++) {
+            if (bfs->shares[s].endIndex >= 0) endPosition = (long long)nextTotal + bfs->shares[s].endIndex;
+            nextTotal += bfs->shares[s].size[!parity];
+        }
+        if (endPosition >= 0 || nextTotal == 0) {
+            if (worker->index == 0) {
+                bfs->found = endPosition >= 0;
+                bfs->nodes = processed + (bfs->found ? endPosition + 1 : 0);
+            }
+            break;
+        }
+        parity = !parity;
+    }
+    return NULL;
+}
+
+int parallelBfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored, int threads) {
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    if (startCell == endCell) {
+        // The queue BFS dequeues the start and stops.
+        return bfsSolveMaze(maze, path, nodesExplored);
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_MAZE_THREADS) threads = MAX_MAZE_THREADS;
+    
+    ParallelBfs* bfs = (ParallelBfs*)calloc(1, sizeof(ParallelBfs));
+    if (bfs == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    bfs->maze = maze;
+    bfs->endCell = endCell;
+    bfs->threads = threads;
+    initMazeSearch(&bfs->search, maze);
+    bfs->claim = (unsigned char*)calloc(threads > 1 ? mazeWords(maze) * 64 : 1, 1);
+    if (bfs->claim == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    clearMazeBit(bfs->search.unvisited, startCell);
+    pushShareCell(&bfs->shares[0], 0, startCell);
+    pthread_barrier_init(&bfs->barrier, NULL, (unsigned int)threads);
+    
+    ParallelBfsWorker workers[MAX_MAZE_THREADS];
+    pthread_t handles[MAX_MAZE_THREADS];
+    for (int t = 0; t < threads; t++) {
+        workers[t].bfs = bfs;
+        workers[t].index = t;
+    }
+    // The calling thread works as thread 0.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, parallelBfsWorker, &workers[t]) != 0) {
+            printf("Failed to start maze search thread!\n");
+            exit(1);
+        }
+    }
+    parallelBfsWorker(&workers[0]);
+    for (int t = 1; t < threads; t++) pthread_join(handles[t], NULL);
+    
+    int found = bfs->found;
+    *nodesExplored = bfs->nodes;
+    if (found) buildMazePath(maze, &bfs->search, startCell, endCell, path);
+    
+    pthread_barrier_destroy(&bfs->barrier);
+    for (int t = 0; t < threads; t++) {
+        free(bfs->shares[t].cells[0]);
+        free(bfs->shares[t].cells[1]);
+    }
+    free(bfs->claim);
+    freeMazeSearch(&bfs->search);
+    free(bfs);
+    return found;
+}
\ No newline at end of file
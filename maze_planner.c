@@ -0,0 +1,270 @@
+#include "ai_agent.h"
+
+// Incremental Replanning
+// D* Lite (Koenig and Likhachev): one backward search from the end is
+// repaired after each change instead of being rerun. A cell whose wall
+// flips only changes the lookahead (rhs) of itself and its four
+// neighbours; the queue then settles just the cells whose cost to the end
+// really changed, so replanning costs grow with the change, not the maze.
+// A moving start keeps the old queue: its keys were computed for an
+// earlier start, and since the heuristic is a distance, adding how far the
+// start has moved (km) to every new key keeps the old ones lower bounds.
+
+#define PLANNER_INFINITY MAZE_NO_CELL
+
+static inline unsigned int plannerMin(unsigned int a, unsigned int b) {
+    return a < b ? a : b;
+}
+
+// Lexicographic [min(g, rhs) + h + km, min(g, rhs)] packed in one word.
+static unsigned long long plannerKey(const MazePlanner* planner, unsigned int cell) {
+    unsigned int best = plannerMin(planner->g[cell], planner->rhs[cell]);
+    if (best == PLANNER_INFINITY) return ~0ULL;
+    unsigned long long first = (unsigned long long)best + mazeManhattan(&planner->maze, planner->startCell, cell) + planner->keyModifier;
+    return first << 32 | best;
+}
+
+// Cheapest way to the end through one of cell's open neighbours.
+static unsigned int plannerLookahead(const MazePlanner* planner, unsigned int cell) {
+    if (cell == planner->endCell) return 0;
+    if (!testMazeBit(planner->maze.open, cell)) return PLANNER_INFINITY;
+    unsigned int best = PLANNER_INFINITY;
+    int neighbours = mazeNeighbours(planner->maze.open, cell, planner->maze.stride);
+    while (neighbours) {
+        unsigned int next = cell + mazeStep(&planner->maze, __builtin_ctz(neighbours));
+        neighbours &= neighbours - 1;
+        if (planner->g[next] == PLANNER_INFINITY) continue;
+        best = plannerMin(best, planner->g[next] + mazeWeight(&planner->maze, next));
+    }
+    return best;
+}
+
+// Queues cell with a fresh key if g and rhs disagree, dequeues it if not.
+static void updatePlannerCell(MazePlanner* planner, unsigned int cell) {
+    removeMazeHeap(&planner->heap, cell);
+    if (planner->g[cell] != planner->rhs[cell]) pushMazeHeap(&planner->heap, cell, plannerKey(planner, cell));
+}
+
+static long long settlePlanner(MazePlanner* planner) {
+    MazeHeap* heap = &planner->heap;
+    const Maze* maze = &planner->maze;
+    long long expanded = 0;
+    
+    while (heap->size > 0 && (heap->keys[0] < plannerKey(planner, planner->startCell) ||
+                              planner->rhs[planner->startCell] != planner->g[planner->startCell])) {
+        unsigned int cell = heap->cells[0];
+        unsigned long long oldKey = heap->keys[0];
+        unsigned long long newKey = plannerKey(planner, cell);
+        expanded++;
+        if (oldKey < newKey) {
+            // Queued before the start last moved.
+            removeMazeHeap(heap, cell);
+            pushMazeHeap(heap, cell, newKey);
+            continue;
+        }
+        
+        popMazeHeap(heap);
+        unsigned int weight = mazeWeight(maze, cell);
+        int neighbours = mazeNeighbours(maze->open, cell, maze->stride);
+        if (planner->g[cell] > planner->rhs[cell]) {
+            // Cheaper than before: neighbours may now go through cell.
+            planner->g[cell] = planner->rhs[cell];
+            while (neighbours) {
+                unsigned int previous = cell + mazeStep(maze, __builtin_ctz(neighbours));
+                neighbours &= neighbours - 1;
+                if (previous == planner->endCell || planner->g[cell] + weight >= planner->rhs[previous]) continue;
+                planner->rhs[previous] = planner->g[cell] + weight;
+                updatePlannerCell(planner, previous);
+            }
+        } else {
+            // Dearer than before: cell and every neighbour that went
+            // through it look again.
+            unsigned int oldCost = planner->g[cell];
+            planner->g[cell] = PLANNER_INFINITY;
+            planner->rhs[cell] = plannerLookahead(planner, cell);
+            updatePlannerCell(planner, cell);
+            while (neighbours) {
+                unsigned int previous = cell + mazeStep(maze, __builtin_ctz(neighbours));
+                neighbours &= neighbours - 1;
+                if (previous == planner->endCell || planner->rhs[previous] != oldCost + weight) continue;
+                planner->rhs[previous] = plannerLookahead(planner, previous);
+                updatePlannerCell(planner, previous);
+            }
+        }
+    }
+    return expanded;
+}
+
+// Takes its own copy of maze's walls, so the maze may be mapped read-only
+// and is never changed. Nothing is searched until replanMazePath.
+void initMazePlanner(MazePlanner* planner, const Maze* maze) {
+    size_t words = mazeWords(maze), cells = words * 64;
+    planner->maze = *maze;
+    planner->maze.mappedBytes = 0;
+    planner->maze.open = (unsigned long long*)malloc(words * sizeof(unsigned long long));
+    planner->g = (unsigned int*)malloc(cells * sizeof(unsigned int));
+    planner->rhs = (unsigned int*)malloc(cells * sizeof(unsigned int));
+    if (planner->maze.open == NULL || planner->g == NULL || planner->rhs == NULL) {
+        printf("Memory allocation failed for maze planner!\n");
+        exit(1);
+    }
+    memcpy(planner->maze.open, maze->open, words * sizeof(unsigned long long));
+    memset(planner->g, 0xFF, cells * sizeof(unsigned int));
+    memset(planner->rhs, 0xFF, cells * sizeof(unsigned int));
+    initMazeHeap(&planner->heap, cells);
+    
+    planner->startCell = planner->lastStart = mazeIndex(maze, maze->start.x, maze->start.y);
+    planner->endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    planner->keyModifier = 0;
+    planner->updates = planner->expansions = 0;
+    planner->rhs[planner->endCell] = 0;
+    updatePlannerCell(planner, planner->endCell);
+}
+
+void freeMazePlanner(MazePlanner* planner) {
+    freeMazeHeap(&planner->heap);
+    free(planner->maze.open);
+    free(planner->g);
+    free(planner->rhs);
+    planner->maze.open = NULL;
+}
+
+// Brings the search up to date with every change so far and stores the
+// cheapest path from the current start. Following the cheapest neighbour
+// always lowers g by at least one, so the walk ends at the end cell.
+int replanMazePath(MazePlanner* planner, MazePath* path, long long* nodesExplored) {
+    *nodesExplored = settlePlanner(planner);
+    planner->expansions += *nodesExplored;
+    if (planner->g[planner->startCell] == PLANNER_INFINITY) return 0;
+    
+    size_t capacity = 1024;
+    path->cells = (unsigned int*)malloc(capacity * sizeof(unsigned int));
+    if (path->cells == NULL) {
+        printf("Memory allocation failed for maze path!\n");
+        exit(1);
+    }
+    path->length = 0;
+    const Maze* maze = &planner->maze;
+    unsigned int cell = planner->startCell;
+    while (1) {
+        if ((size_t)path->length == capacity) {
+            capacity *= 2;
+            path->cells = (unsigned int*)realloc(path->cells, capacity * sizeof(unsigned int));
+            if (path->cells == NULL) {
+                printf("Memory allocation failed for maze path!\n");
+                exit(1);
+            }
+        }
+        path->cells[path->length++] = cell;
+        if (cell == planner->endCell) break;
+        
+        unsigned int best = PLANNER_INFINITY, bestNext = cell;
+        int neighbours = mazeNeighbours(maze->open, cell, maze->stride);
+        while (neighbours) {
+            unsigned int next = cell + mazeStep(maze, __builtin_ctz(neighbours));
+            neighbours &= neighbours - 1;
+            if (planner->g[next] == PLANNER_INFINITY) continue;
+            unsigned int cost = planner->g[next] + mazeWeight(maze, next);
+            if (cost < best) {
+                best = cost;
+                bestNext = next;
+            }
+        }
+        cell = bestNext;
+    }
+    return 1;
+}
+
+// Opens or walls up one cell. The start and end cannot be walled up.
+// Returns 0 if the change was refused.
+int setMazePlannerCell(MazePlanner* planner, MazePoint point, int open) {
+    Maze* maze = &planner->maze;
+    if (point.x < 0 || point.x >= maze->height || point.y < 0 || point.y >= maze->width) return 0;
+    unsigned int cell = mazeIndex(maze, point.x, point.y);
+    if (!open && (cell == planner->startCell || cell == planner->endCell)) return 0;
+    if (testMazeBit(maze->open, cell) == open) return 1;
+    
+    if (open) setMazeBit(maze->open, cell);
+    else clearMazeBit(maze->open, cell);
+    planner->updates++;
+    if (cell != planner->endCell) {
+        planner->rhs[cell] = plannerLookahead(planner, cell);
+        updatePlannerCell(planner, cell);
+    }
+    for (int direction = 0; direction < 4; direction++) {
+        unsigned int next = cell + mazeStep(maze, direction);
+        if (next == planner->endCell || !testMazeBit(maze->open, next)) continue;
+        planner->rhs[next] = plannerLookahead(planner, next);
+        updatePlannerCell(planner, next);
+    }
+    return 1;
+}
+
+// Moves the start to an open cell. Returns 0 if point is not one.
+int moveMazePlannerStart(MazePlanner* planner, MazePoint point) {
+    Maze* maze = &planner->maze;
+    if (point.x < 0 || point.x >= maze->height || point.y < 0 || point.y >= maze->width) return 0;
+    unsigned int cell = mazeIndex(maze, point.x, point.y);
+    if (!testMazeBit(maze->open, cell)) return 0;
+    planner->keyModifier += mazeManhattan(maze, planner->lastStart, cell);
+    planner->lastStart = planner->startCell = cell;
+    maze->start = point;
+    return 1;
+}
+
+// Replanning demo: an agent walks its path and, like a robot with a short
+// sensor range, sees cells flip within MAZE_SENSOR_RANGE of itself. Each
+// repaired plan is checked against weighted A* run from scratch.
+void playMazeReplanning() {
+    printf("\n=== MAZE REPLANNING ===\n");
+    Maze maze;
+    if (!inputMaze(&maze, 1)) return;
+    int rounds = getIntegerInput("Enter rounds (1-10000): ", 1, 10000);
+    int changes = getIntegerInput("Enter cells changed per round (1-1000): ", 1, 1000);
+    
+    MazePlanner planner;
+    MazePath path = {NULL, 0};
+    long long nodes;
+    long long start = monotonicNanos();
+    initMazePlanner(&planner, &maze);
+    int found = replanMazePath(&planner, &path, &nodes);
+    printf("\nFirst plan: %s, %lld nodes, %.4f seconds\n", found ? "path found" : "no path", nodes, (monotonicNanos() - start) / 1e9);
+    
+    Rng rng;
+    rngSeed(&rng, (unsigned long long)monotonicNanos());
+    double replanSeconds = 0, scratchSeconds = 0;
+    long long replanNodes = 0, scratchNodes = 0, mismatches = 0;
+    for (int round = 0; round < rounds; round++) {
+        if (found && path.length > 1) moveMazePlannerStart(&planner, mazePointOf(&planner.maze, path.cells[1]));
+        for (int c = 0; c < changes; c++) {
+            MazePoint p = planner.maze.start;
+            p.x += rngBelow(&rng, 2 * MAZE_SENSOR_RANGE + 1) - MAZE_SENSOR_RANGE;
+            p.y += rngBelow(&rng, 2 * MAZE_SENSOR_RANGE + 1) - MAZE_SENSOR_RANGE;
+            if (p.x < 0 || p.x >= maze.height || p.y < 0 || p.y >= maze.width) continue;
+            setMazePlannerCell(&planner, p, !testMazeBit(planner.maze.open, mazeIndex(&planner.maze, p.x, p.y)));
+        }
+        
+        freeMazePath(&path);
+        start = monotonicNanos();
+        found = replanMazePath(&planner, &path, &nodes);
+        replanSeconds += (monotonicNanos() - start) / 1e9;
+        replanNodes += nodes;
+        
+        MazePath scratch = {NULL, 0};
+        start = monotonicNanos();
+        int scratchFound = weightedAStarSolveMaze(&planner.maze, &scratch, &nodes);
+        scratchSeconds += (monotonicNanos() - start) / 1e9;
+        scratchNodes += nodes;
+        if (scratchFound != found || (found && mazePathCost(&planner.maze, &scratch) != mazePathCost(&planner.maze, &path))) mismatches++;
+        freeMazePath(&scratch);
+    }
+    
+    printf("%d rounds, %lld cells changed\n", rounds, planner.updates);
+    printf("Replanning: %.6f seconds and %lld nodes per round\n", replanSeconds / rounds, replanNodes / rounds);
+    printf("From scratch (weighted A*): %.6f seconds and %lld nodes per round\n", scratchSeconds / rounds, scratchNodes / rounds);
+    printf("Plans that differ in cost: %lld\n", mismatches);
+    
+    freeMazePath(&path);
+    freeMazePlanner(&planner);
+    freeMaze(&maze);
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "ai_agent.h"
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+// Maze Renderer
+// A frame is built in one buffer and written with a single write(). The
+// path is a bitset laid out like maze->open, so each cell is looked up in
+// O(1) instead of searching the path for it. Mazes larger than the view
+// are downsampled: each character stands for a scale x scale block, which
+// shows S or E if it holds them, the path if any of its cells are on it,
+// and otherwise open or wall by majority, counted a word of cells at a
+// time. The incremental mode remembers the glyph drawn at each position
+// and only moves the cursor (with ANSI escapes) to the ones that changed,
+// so animating a search costs a few bytes per frame.
+
+#define RENDER_PATH '.'             // drawn as a middle dot
+#define RENDER_VISITED 'o'
+
+static void appendRender(MazeRenderer* renderer, const char* text, size_t bytes) {
+    if (renderer->length + bytes > renderer->capacity) {
+        size_t grown = renderer->capacity * 2 > renderer->length + bytes ? renderer->capacity * 2 : renderer->length + bytes + 4096;
+        renderer->buffer = (char*)realloc(renderer->buffer, grown);
+        if (renderer->buffer == NULL) {
+            printf("Memory allocation failed for maze renderer!\n");
+            exit(1);
+        }
+        renderer->capacity = grown;
+    }
+    memcpy(renderer->buffer + renderer->length, text, bytes);
+    renderer->length += bytes;
+}
+
+static void appendGlyph(MazeRenderer* renderer, char glyph) {
+    if (glyph == RENDER_PATH) appendRender(renderer, "\xC2\xB7", 2);
+    else appendRender(renderer, &glyph, 1);
+}
+
+// Anything printf still holds goes out first, then the frame in one
+// write() unless the terminal takes it in parts.
+static void flushRender(MazeRenderer* renderer) {
+    fflush(stdout);
+    size_t done = 0;
+    while (done < renderer->length) {
+        ssize_t wrote = write(STDOUT_FILENO, renderer->buffer + done, renderer->length - done);
+        if (wrote <= 0) break;
+        done += (size_t)wrote;
+    }
+    renderer->length = 0;
+}
+
+// Set bits among count bits of bits starting at from.
+static int countMazeBits(const unsigned long long* bits, unsigned int from, unsigned int count) {
+    int total = 0;
+    while (count > 0) {
+        unsigned int offset = from & 63;
+        unsigned int take = 64 - offset < count ? 64 - offset : count;
+        unsigned long long word = bits[from >> 6] >> offset;
+        if (take < 64) word &= (1ULL << take) - 1;
+        total += __builtin_popcountll(word);
+        from += take;
+        count -= take;
+    }
+    return total;
+}
+
+static inline int pointInBlock(MazePoint p, int top, int left, int bottom, int right) {
+    return p.x >= top && p.x < bottom && p.y >= left && p.y < right;
+}
+
+// Glyph for the character at row, column of the view.
+static char blockGlyph(const MazeRenderer* renderer, int row, int column) {
+    const Maze* maze = renderer->maze;
+    int top = renderer->top + row * renderer->scale, left = renderer->left + column * renderer->scale;
+    if (renderer->scale == 1) {
+        unsigned int cell = mazeIndex(maze, top, left);
+        if (top == maze->start.x && left == maze->start.y) return 'S';
+        if (top == maze->end.x && left == maze->end.y) return 'E';
+        if (testMazeBit(renderer->path, cell)) return RENDER_PATH;
+        if (testMazeBit(renderer->visited, cell)) return RENDER_VISITED;
+        if (!testMazeBit(maze->open, cell)) return '#';
+        return mazeWeight(maze, cell) > 1 ? (char)('0' + mazeWeight(maze, cell)) : ' ';
+    }
+    
+    int bottom = top + renderer->scale < maze->height ? top + renderer->scale : maze->height;
+    int right = left + renderer->scale < maze->width ? left + renderer->scale : maze->width;
+    if (pointInBlock(maze->start, top, left, bottom, right)) return 'S';
+    if (pointInBlock(maze->end, top, left, bottom, right)) return 'E';
+    unsigned int columns = (unsigned int)(right - left);
+    int open = 0, path = 0, visited = 0;
+    for (int x = top; x < bottom; x++) {
+        unsigned int cell = mazeIndex(maze, x, left);
+        open += countMazeBits(maze->open, cell, columns);
+        path += countMazeBits(renderer->path, cell, columns);
+        visited += countMazeBits(renderer->visited, cell, columns);
+    }
+    if (path > 0) return RENDER_PATH;
+    if (visited > 0) return RENDER_VISITED;
+    return open * 2 >= (bottom - top) * (int)columns ? ' ' : '#';
+}
+
+static void appendBorder(MazeRenderer* renderer) {
+    appendRender(renderer, "+", 1);
+    for (int j = 0; j < renderer->columns; j++) appendRender(renderer, "-", 1);
+    appendRender(renderer, "+\n", 2);
+}
+
+// The view in the notation readMazeText reads, recording each glyph in
+// shown if that is not NULL. Only a scale 1 view with no path or visited
+// marks reads back unchanged: marks hide the weight digits under them.
+static void appendFrame(MazeRenderer* renderer, unsigned char* shown) {
+    appendBorder(renderer);
+    for (int i = 0; i < renderer->rows; i++) {
+        appendRender(renderer, "|", 1);
+        for (int j = 0; j < renderer->columns; j++) {
+            char glyph = blockGlyph(renderer, i, j);
+            if (shown != NULL) shown[(size_t)i * renderer->columns + j] = (unsigned char)glyph;
+            appendGlyph(renderer, glyph);
+        }
+        appendRender(renderer, "|\n", 2);
+    }
+    appendBorder(renderer);
+}
+
+// Rows and columns of the terminal on stdout, 0 if it is not one.
+static void terminalSize(int* rows, int* columns) {
+    struct winsize size;
+    *rows = *columns = 0;
+    if (isatty(STDOUT_FILENO) && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+        *rows = size.ws_row;
+        *columns = size.ws_col;
+    }
+}
+
+// A view of the whole maze at most maxRows x maxColumns characters,
+// borders excluded, at the smallest scale that fits.
+void initMazeRenderer(MazeRenderer* renderer, const Maze* maze, int maxRows, int maxColumns) {
+    memset(renderer, 0, sizeof(*renderer));
+    renderer->maze = maze;
+    renderer->maxRows = maxRows < 1 ? 1 : maxRows;
+    renderer->maxColumns = maxColumns < 1 ? 1 : maxColumns;
+    renderer->path = (unsigned long long*)calloc(mazeWords(maze), sizeof(unsigned long long));
+    renderer->visited = (unsigned long long*)calloc(mazeWords(maze), sizeof(unsigned long long));
+    if (renderer->path == NULL || renderer->visited == NULL) {
+        printf("Memory allocation failed for maze renderer!\n");
+        exit(1);
+    }
+    int scale = (maze->height + renderer->maxRows - 1) / renderer->maxRows;
+    int widthScale = (maze->width + renderer->maxColumns - 1) / renderer->maxColumns;
+    setMazeViewport(renderer, 0, 0, scale > widthScale ? scale : widthScale);
+}
+
+void freeMazeRenderer(MazeRenderer* renderer) {
+    free(renderer->path);
+    free(renderer->visited);
+    free(renderer->shown);
+    free(renderer->buffer);
+    memset(renderer, 0, sizeof(*renderer));
+}
+
+// Shows the maze from cell (top, left) at scale cells per character, as
+// much of it as fits. The next incremental frame is drawn in full.
+void setMazeViewport(MazeRenderer* renderer, int top, int left, int scale) {
+    const Maze* maze = renderer->maze;
+    renderer->scale = scale < 1 ? 1 : scale;
+    renderer->top = top < 0 ? 0 : top >= maze->height ? maze->height - 1 : top;
+    renderer->left = left < 0 ? 0 : left >= maze->width ? maze->width - 1 : left;
+    int rows = (maze->height - renderer->top + renderer->scale - 1) / renderer->scale;
+    int columns = (maze->width - renderer->left + renderer->scale - 1) / renderer->scale;
+    renderer->rows = rows < renderer->maxRows ? rows : renderer->maxRows;
+    renderer->columns = columns < renderer->maxColumns ? columns : renderer->maxColumns;
+    free(renderer->shown);
+    renderer->shown = NULL;
+}
+
+// Replaces the marked path; NULL or an empty path clears it.
+void setMazeRendererPath(MazeRenderer* renderer, const MazePath* path) {
+    memset(renderer->path, 0, mazeWords(renderer->maze) * sizeof(unsigned long long));
+    if (path == NULL) return;
+    for (long long k = 0; k < path->length; k++) setMazeBit(renderer->path, path->cells[k]);
+}
+
+// Marks a cell as reached by a search, drawn as 'o' until the path
+// covers it.
+void markMazeRendererCell(MazeRenderer* renderer, unsigned int cell) {
+    setMazeBit(renderer->visited, cell);
+}
+
+void renderMaze(MazeRenderer* renderer) {
+    appendFrame(renderer, NULL);
+    flushRender(renderer);
+}
+
+// Redraws in place: the first frame clears the screen and draws it all,
+// later ones only the characters that changed, and every frame leaves
+// the cursor on the line below the maze.
+void renderMazeChanges(MazeRenderer* renderer) {
+    if (renderer->shown == NULL) {
+        renderer->shown = (unsigned char*)malloc((size_t)renderer->rows * renderer->columns);
+        if (renderer->shown == NULL) {
+            printf("Memory allocation failed for maze renderer!\n");
+            exit(1);
+        }
+        appendRender(renderer, "\x1b[H\x1b[2J", 7);
+        appendFrame(renderer, renderer->shown);
+        flushRender(renderer);
+        return;
+    }
+    
+    char move[32];
+    for (int i = 0; i < renderer->rows; i++) {
+        for (int j = 0; j < renderer->columns; j++) {
+            char glyph = blockGlyph(renderer, i, j);
+            unsigned char* shown = &renderer->shown[(size_t)i * renderer->columns + j];
+            if (*shown == (unsigned char)glyph) continue;
+            *shown = (unsigned char)glyph;
+            // The frame's top border is terminal row 1, its left border column 1.
+            int bytes = snprintf(move, sizeof(move), "\x1b[%d;%dH", i + 2, j + 2);
+            appendRender(renderer, move, (size_t)bytes);
+            appendGlyph(renderer, glyph);
+        }
+    }
+    int bytes = snprintf(move, sizeof(move), "\x1b[%d;1H", renderer->rows + 3);
+    appendRender(renderer, move, (size_t)bytes);
+    flushRender(renderer);
+}
+
+// Draws the maze with path marked, downsampled to at most
+// MAZE_PRINT_LIMIT characters a side and the width of the terminal.
+void printMaze(const Maze* maze, const MazePath* path) {
+    int rows, columns;
+    terminalSize(&rows, &columns);
+    int maxColumns = columns > 2 && columns - 2 < MAZE_PRINT_LIMIT ? columns - 2 : MAZE_PRINT_LIMIT;
+    
+    MazeRenderer renderer;
+    initMazeRenderer(&renderer, maze, MAZE_PRINT_LIMIT, maxColumns);
+    setMazeRendererPath(&renderer, path);
+    if (renderer.scale > 1) printf("(each character stands for %dx%d cells)\n", renderer.scale, renderer.scale);
+    appendRender(&renderer, "\n", 1);
+    renderMaze(&renderer);
+    freeMazeRenderer(&renderer);
+}
+
+// Whether stdin and stdout are both a terminal, so an animation can be
+// shown and the user asked about it.
+int mazeAnimationAvailable() {
+    return isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+}
+
+// Replays a BFS from the start on the terminal, a layer of cells per
+// frame, then draws path over what it reached. The first 100 layers get
+// a frame each; after that frames take more and more layers, so long
+// mazes still finish in seconds.
+void animateMazeBfs(const Maze* maze, const MazePath* path) {
+    int rows, columns;
+    terminalSize(&rows, &columns);
+    if (rows < 6 || columns < 4) {
+        rows = MAZE_PRINT_LIMIT + 3;
+        columns = MAZE_PRINT_LIMIT + 2;
+    }
+    MazeRenderer renderer;
+    initMazeRenderer(&renderer, maze, rows - 3, columns - 2);   // borders and the line under them
+    
+    MazeSearch search;
+    MazeStack layer, next;
+    initMazeSearch(&search, maze);
+    initMazeStack(&layer);
+    initMazeStack(&next);
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    clearMazeBit(search.unvisited, startCell);
+    pushMaze(&layer, startCell);
+    renderMazeChanges(&renderer);
+    
+    struct timespec pause = {0, MAZE_FRAME_MILLIS * 1000000L};
+    for (long long depth = 0; !isMazeStackEmpty(&layer); depth++) {
+        while (!isMazeStackEmpty(&layer)) {
+            unsigned int cell = popMaze(&layer);
+            markMazeRendererCell(&renderer, cell);
+            int neighbours = mazeNeighbours(search.unvisited, cell, maze->stride);
+            while (neighbours) {
+                int direction = __builtin_ctz(neighbours);
+                neighbours &= neighbours - 1;
+                unsigned int adjacent = cell + mazeStep(maze, direction);
+                clearMazeBit(search.unvisited, adjacent);
+                pushMaze(&next, adjacent);
+            }
+        }
+        MazeStack swap = layer;
+        layer = next;
+        next = swap;
+        if (depth % (1 + depth / 100) == 0) {
+            renderMazeChanges(&renderer);
+            nanosleep(&pause, NULL);
+        }
+    }
+    setMazeRendererPath(&renderer, path);
+    renderMazeChanges(&renderer);
+    
+    freeMazeStack(&layer);
+    freeMazeStack(&next);
+    freeMazeSearch(&search);
+    freeMazeRenderer(&renderer);
+}
\ No newline at end of file
@@ -1,259 +1,490 @@
 #include "ai_agent.h"
+#include <sys/mman.h>
+
+// Maze Grid Functions
+// Allocates an all-wall width x height maze.
+void initMaze(Maze* maze, int width, int height) {
+    maze->width = width;
+    maze->height = height;
+    maze->stride = (unsigned int)(width + 2 + 63) / 64 * 64;
+    maze->weight = NULL;
+    maze->mappedBytes = 0;
+    maze->open = (unsigned long long*)calloc(mazeWords(maze), sizeof(unsigned long long));
+    if (maze->open == NULL) {
+        printf("Memory allocation failed for %dx%d maze!\n", width, height);
+        exit(1);
+    }
+}
+
+void freeMaze(Maze* maze) {
+    if (maze->mappedBytes) {
+        munmap((char*)maze->open - sizeof(MazeFileHeader), maze->mappedBytes);
+    } else {
+        free(maze->open);
+        free(maze->weight);
+    }
+    maze->open = NULL;
+    maze->weight = NULL;
+}
+
+void initMazeSearch(MazeSearch* search, const Maze* maze) {
+    size_t words = mazeWords(maze);
+    search->unvisited = (unsigned long long*)malloc(words * sizeof(unsigned long long));
+    search->parentDir = (unsigned long long*)calloc(words * 2, sizeof(unsigned long long));
+    if (search->unvisited == NULL || search->parentDir == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    memcpy(search->unvisited, maze->open, words * sizeof(unsigned long long));
+}
+
+void freeMazeSearch(MazeSearch* search) {
+    free(search->unvisited);
+    free(search->parentDir);
+}
+
+static void* growMazeBuffer(void* buffer, size_t* capacity, size_t elementSize) {
+    size_t grown = *capacity ? *capacity * 2 : 1024;
+    buffer = realloc(buffer, grown * elementSize);
+    if (buffer == NULL) {
+        printf("Memory allocation failed for maze frontier!\n");
+        exit(1);
+    }
+    *capacity = grown;
+    return buffer;
+}
 
 // Maze Helper Functions
 void initMazeQueue(MazeQueue* q) {
-    q->front = q->rear = -1;
+    q->cells = NULL;
+    q->head = q->tail = q->capacity = 0;
 }
 
-void enqueueMaze(MazeQueue* q, MazePoint p) {
-    if (q->rear == MAX_QUEUE_SIZE - 1) return;
-    if (q->front == -1) q->front = 0;
-    q->rear++;
-    q->points[q->rear] = p;
+// Dequeued slots are not reused: with every cell enqueued at most once
+// the queue peaks at the number of reachable cells anyway.
+void enqueueMaze(MazeQueue* q, unsigned int cell) {
+    if (q->tail == q->capacity) q->cells = growMazeBuffer(q->cells, &q->capacity, sizeof(unsigned int));
+    q->cells[q->tail++] = cell;
 }
 
-MazePoint dequeueMaze(MazeQueue* q) {
-    MazePoint p = q->points[q->front];
-    if (q->front == q->rear) {
-        q->front = q->rear = -1;
-    } else {
-        q->front++;
-    }
-    return p;
+unsigned int dequeueMaze(MazeQueue* q) {
+    return q->cells[q->head++];
 }
 
 int isMazeQueueEmpty(MazeQueue* q) {
-    return q->front == -1;
+    return q->head == q->tail;
+}
+
+void freeMazeQueue(MazeQueue* q) {
+    free(q->cells);
+    initMazeQueue(q);
 }
 
 void initMazeStack(MazeStack* s) {
-    s->top = -1;
+    s->cells = NULL;
+    s->top = s->capacity = 0;
 }
 
-void pushMaze(MazeStack* s, MazePoint p) {
-    if (s->top == MAX_STACK_SIZE - 1) return;
-    s->top++;
-    s->points[s->top] = p;
+void pushMaze(MazeStack* s, unsigned int cell) {
+    if (s->top == s->capacity) s->cells = growMazeBuffer(s->cells, &s->capacity, sizeof(unsigned int));
+    s->cells[s->top++] = cell;
 }
 
-MazePoint popMaze(MazeStack* s) {
-    MazePoint p = s->points[s->top];
-    s->top--;
-    return p;
+unsigned int popMaze(MazeStack* s) {
+    return s->cells[--s->top];
 }
 
 int isMazeStackEmpty(MazeStack* s) {
-    return s->top == -1;
+    return s->top == 0;
 }
 
-void generateMaze(Maze* maze, int width, int height, float wallDensity) {
-    maze->width = width;
-    maze->height = height;
+void freeMazeStack(MazeStack* s) {
+    free(s->cells);
+    initMazeStack(s);
+}
+
+void freeMazePath(MazePath* path) {
+    free(path->cells);
+    path->cells = NULL;
+    path->length = 0;
+}
+
+// Follows parent directions back from end to start and stores the path
+// start first.
+void buildMazePath(const Maze* maze, const MazeSearch* search, unsigned int start, unsigned int end, MazePath* path) {
+    long long length = 1;
+    for (unsigned int cell = end; cell != start; cell -= mazeStep(maze, parentDirection(search, cell))) length++;
     
-    for (int i = 0; i < height; i++) {
-        for (int j = 0; j < width; j++) {
-            maze->maze[i][j] = ' ';
-        }
+    path->cells = (unsigned int*)malloc(length * sizeof(unsigned int));
+    if (path->cells == NULL) {
+        printf("Memory allocation failed for maze path!\n");
+        exit(1);
     }
+    path->length = length;
+    unsigned int cell = end;
+    for (long long i = length - 1; i >= 0; i--) {
+        path->cells[i] = cell;
+        if (i > 0) cell -= mazeStep(maze, parentDirection(search, cell));
+    }
+}
+
+void generateMaze(Maze* maze, int width, int height, float wallDensity, unsigned long long seed) {
+    initMaze(maze, width, height);
     
-    srand(time(NULL));
+    Rng rng;
+    rngSeed(&rng, seed);
     for (int i = 0; i < height; i++) {
         for (int j = 0; j < width; j++) {
-            if ((float)rand() / RAND_MAX < wallDensity) {
-                maze->maze[i][j] = '#';
+            if ((float)(rngNext(&rng) >> 40) / (1 << 24) >= wallDensity) {
+                setMazeBit(maze->open, mazeIndex(maze, i, j));
             }
         }
     }
     
     maze->start.x = 0; maze->start.y = 0;
     maze->end.x = height - 1; maze->end.y = width - 1;
-    maze->maze[0][0] = 'S';
-    maze->maze[height-1][width-1] = 'E';
     
     for (int i = 0; i < 2; i++) {
         for (int j = 0; j < 2; j++) {
-            if (i < height && j < width) maze->maze[i][j] = ' ';
-            if (height-1-i >= 0 && width-1-j >= 0) 
-                maze->maze[height-1-i][width-1-j] = ' ';
-        }
-    }
-    maze->maze[0][0] = 'S';
-    maze->maze[height-1][width-1] = 'E';
-}
-
-void printMaze(Maze* maze, MazePoint path[], int pathLength) {
-    printf("\n+");
-    for (int j = 0; j < maze->width; j++) printf("-");
-    printf("+\n");
-    
-    for (int i = 0; i < maze->height; i++) {
-        printf("|");
-        for (int j = 0; j < maze->width; j++) {
-            int onPath = 0;
-            for (int k = 0; k < pathLength; k++) {
-                if (path[k].x == i && path[k].y == j && 
-                    maze->maze[i][j] != 'S' && maze->maze[i][j] != 'E') {
-                    onPath = 1;
-                    break;
-                }
-            }
-            
-            if (onPath) printf("·");
-            else printf("%c", maze->maze[i][j]);
+            if (i < height && j < width) setMazeBit(maze->open, mazeIndex(maze, i, j));
+            if (height-1-i >= 0 && width-1-j >= 0)
+                setMazeBit(maze->open, mazeIndex(maze, height-1-i, width-1-j));
         }
-        printf("|\n");
     }
-    
-    printf("+");
-    for (int j = 0; j < maze->width; j++) printf("-");
-    printf("+\n");
-}
-
-int isValidMazeMove(Maze* maze, int x, int y, int visited[MAX_MAZE_SIZE][MAX_MAZE_SIZE]) {
-    return (x >= 0 && x < maze->height && y >= 0 && y < maze->width &&
-            maze->maze[x][y] != '#' && !visited[x][y]);
 }
 
-int bfsSolveMaze(Maze* maze, MazePoint path[], int* pathLength, int* nodesExplored) {
-    int visited[MAX_MAZE_SIZE][MAX_MAZE_SIZE] = {0};
-    MazePoint parent[MAX_MAZE_SIZE][MAX_MAZE_SIZE];
+int bfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    MazeSearch search;
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
     MazeQueue q;
+    int found = 0;
     
+    initMazeSearch(&search, maze);
     initMazeQueue(&q);
-    enqueueMaze(&q, maze->start);
-    visited[maze->start.x][maze->start.y] = 1;
-    parent[maze->start.x][maze->start.y] = (MazePoint){-1, -1};
+    enqueueMaze(&q, startCell);
+    clearMazeBit(search.unvisited, startCell);
     *nodesExplored = 0;
     
-    int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
-    
     while (!isMazeQueueEmpty(&q)) {
-        MazePoint current = dequeueMaze(&q);
+        unsigned int current = dequeueMaze(&q);
         (*nodesExplored)++;
         
-        if (current.x == maze->end.x && current.y == maze->end.y) {
-            *pathLength = 0;
-            MazePoint temp = current;
-            
-            while (temp.x != -1 && temp.y != -1) {
-                path[*pathLength] = temp;
-                (*pathLength)++;
-                temp = parent[temp.x][temp.y];
-            }
-            
-            for (int i = 0; i < *pathLength / 2; i++) {
-                MazePoint temp = path[i];
-                path[i] = path[*pathLength - 1 - i];
-                path[*pathLength - 1 - i] = temp;
-            }
-            return 1;
+        if (current == endCell) {
+            buildMazePath(maze, &search, startCell, current, path);
+            found = 1;
+            break;
         }
         
-        for (int i = 0; i < 4; i++) {
-            int nx = current.x + directions[i][0];
-            int ny = current.y + directions[i][1];
-            
-            if (isValidMazeMove(maze, nx, ny, visited)) {
-                visited[nx][ny] = 1;
-                parent[nx][ny] = current;
-                enqueueMaze(&q, (MazePoint){nx, ny});
-            }
+        // Open, unvisited neighbours, east, south, west, north.
+        int neighbours = mazeNeighbours(search.unvisited, current, maze->stride);
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            unsigned int next = current + mazeStep(maze, direction);
+            reachMazeCell(&search, next, direction);
+            enqueueMaze(&q, next);
         }
     }
     
-    return 0;
+    freeMazeQueue(&q);
+    freeMazeSearch(&search);
+    return found;
 }
 
-int dfsSolveMaze(Maze* maze, MazePoint path[], int* pathLength, int* nodesExplored) {
-    int visited[MAX_MAZE_SIZE][MAX_MAZE_SIZE] = {0};
-    MazePoint parent[MAX_MAZE_SIZE][MAX_MAZE_SIZE];
+int dfsSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    MazeSearch search;
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
     MazeStack s;
+    int found = 0;
     
+    initMazeSearch(&search, maze);
     initMazeStack(&s);
-    pushMaze(&s, maze->start);
-    visited[maze->start.x][maze->start.y] = 1;
-    parent[maze->start.x][maze->start.y] = (MazePoint){-1, -1};
+    pushMaze(&s, startCell);
+    clearMazeBit(search.unvisited, startCell);
     *nodesExplored = 0;
     
-    int directions[4][2] = {{0,1}, {1,0}, {0,-1}, {-1,0}};
-    
     while (!isMazeStackEmpty(&s)) {
-        MazePoint current = popMaze(&s);
+        unsigned int current = popMaze(&s);
         (*nodesExplored)++;
         
-        if (current.x == maze->end.x && current.y == maze->end.y) {
-            *pathLength = 0;
-            MazePoint temp = current;
-            
-            while (temp.x != -1 && temp.y != -1) {
-                path[*pathLength] = temp;
-                (*pathLength)++;
-                temp = parent[temp.x][temp.y];
-            }
-            
-            for (int i = 0; i < *pathLength / 2; i++) {
-                MazePoint temp = path[i];
-                path[i] = path[*pathLength - 1 - i];
-                path[*pathLength - 1 - i] = temp;
-            }
-            return 1;
+        if (current == endCell) {
+            buildMazePath(maze, &search, startCell, current, path);
+            found = 1;
+            break;
         }
         
-        for (int i = 0; i < 4; i++) {
-            int nx = current.x + directions[i][0];
-            int ny = current.y + directions[i][1];
-            
-            if (isValidMazeMove(maze, nx, ny, visited)) {
-                visited[nx][ny] = 1;
-                parent[nx][ny] = current;
-                pushMaze(&s, (MazePoint){nx, ny});
-            }
+        // Open, unvisited neighbours, east, south, west, north.
+        int neighbours = mazeNeighbours(search.unvisited, current, maze->stride);
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            unsigned int next = current + mazeStep(maze, direction);
+            reachMazeCell(&search, next, direction);
+            pushMaze(&s, next);
+        }
+    }
+    
+    freeMazeStack(&s);
+    freeMazeSearch(&search);
+    return found;
+}
+
+// Expands one whole BFS level of side; returns a cell the other side has
+// already reached, or MAZE_NO_CELL. Because both sides only ever grow by
+// whole levels, the first such cell lies on a shortest path.
+static unsigned int expandBfsLevel(const Maze* maze, MazeSearch* side, MazeQueue* q, const MazeSearch* other, long long* nodesExplored) {
+    size_t levelEnd = q->tail;
+    while (q->head < levelEnd) {
+        unsigned int current = dequeueMaze(q);
+        (*nodesExplored)++;
+        
+        int neighbours = mazeNeighbours(side->unvisited, current, maze->stride);
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            unsigned int next = current + mazeStep(maze, direction);
+            reachMazeCell(side, next, direction);
+            if (!testMazeBit(other->unvisited, next)) return next;
+            enqueueMaze(q, next);
+        }
+    }
+    return MAZE_NO_CELL;
+}
+
+// BFS from both ends at once, each round growing whichever frontier is
+// smaller by one level, until the two meet.
+int bidirectionalSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    MazeSearch forward, backward;
+    MazeQueue forwardQueue, backwardQueue;
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    unsigned int meeting = startCell == endCell ? startCell : MAZE_NO_CELL;
+    
+    initMazeSearch(&forward, maze);
+    initMazeSearch(&backward, maze);
+    initMazeQueue(&forwardQueue);
+    initMazeQueue(&backwardQueue);
+    clearMazeBit(forward.unvisited, startCell);
+    clearMazeBit(backward.unvisited, endCell);
+    enqueueMaze(&forwardQueue, startCell);
+    enqueueMaze(&backwardQueue, endCell);
+    *nodesExplored = 0;
+    
+    while (meeting == MAZE_NO_CELL && !isMazeQueueEmpty(&forwardQueue) && !isMazeQueueEmpty(&backwardQueue)) {
+        size_t forwardSize = forwardQueue.tail - forwardQueue.head;
+        size_t backwardSize = backwardQueue.tail - backwardQueue.head;
+        if (forwardSize <= backwardSize) {
+            meeting = expandBfsLevel(maze, &forward, &forwardQueue, &backward, nodesExplored);
+        } else {
+            meeting = expandBfsLevel(maze, &backward, &backwardQueue, &forward, nodesExplored);
+        }
+    }
+    
+    if (meeting != MAZE_NO_CELL) {
+        // Start to meeting from the forward chain, then meeting to end
+        // from the backward one.
+        MazePath head;
+        buildMazePath(maze, &forward, startCell, meeting, &head);
+        long long tailLength = 0;
+        for (unsigned int cell = meeting; cell != endCell; cell -= mazeStep(maze, parentDirection(&backward, cell))) tailLength++;
+        
+        path->length = head.length + tailLength;
+        path->cells = (unsigned int*)realloc(head.cells, path->length * sizeof(unsigned int));
+        if (path->cells == NULL) {
+            printf("Memory allocation failed for maze path!\n");
+            exit(1);
+        }
+        unsigned int cell = meeting;
+        for (long long i = head.length; i < path->length; i++) {
+            cell -= mazeStep(maze, parentDirection(&backward, cell));
+            path->cells[i] = cell;
+        }
+    }
+    
+    freeMazeQueue(&forwardQueue);
+    freeMazeQueue(&backwardQueue);
+    freeMazeSearch(&forward);
+    freeMazeSearch(&backward);
+    return meeting != MAZE_NO_CELL;
+}
+
+// Solvers by name, for the batch CLI and the benchmark. solve is NULL for
+// the two that need more than the maze; runMazeSolver handles them.
+typedef struct {
+    const char* name;
+    MazeSolver solve;
+} NamedMazeSolver;
+
+static const NamedMazeSolver mazeSolvers[] = {
+    {"bfs", bfsSolveMaze},
+    {"dfs", dfsSolveMaze},
+    {"astar", aStarSolveMaze},
+    {"jps", jpsSolveMaze},
+    {"bidirectional", bidirectionalSolveMaze},
+    {"bitset", bitsetBfsSolveMaze},
+    {"parallel", NULL},         // needs a thread count
+    {"dijkstra", dijkstraSolveMaze},
+    {"weighted-astar", weightedAStarSolveMaze},
+    {"hpa", NULL},              // queries a MazeHierarchy built beforehand
+};
+
+#define MAZE_SOLVERS ((int)(sizeof(mazeSolvers) / sizeof(mazeSolvers[0])))
+
+int mazeSolverCount() {
+    return MAZE_SOLVERS;
+}
+
+const char* mazeSolverName(int solver) {
+    return mazeSolvers[solver].name;
+}
+
+// Index of the solver called name, or -1.
+int findMazeSolver(const char* name) {
+    for (int s = 0; s < MAZE_SOLVERS; s++) {
+        if (strcmp(mazeSolvers[s].name, name) == 0) return s;
+    }
+    return -1;
+}
+
+// Whether runMazeSolver needs an initialized hierarchy for the maze.
+int mazeSolverUsesHierarchy(int solver) {
+    return strcmp(mazeSolvers[solver].name, "hpa") == 0;
+}
+
+// Solves maze with the given solver and returns 1 if end is reachable.
+// threads is used by parallel BFS; hierarchy only by HPA*.
+int runMazeSolver(int solver, Maze* maze, MazeHierarchy* hierarchy, int threads, MazePath* path, long long* nodesExplored) {
+    if (mazeSolvers[solver].solve != NULL) return mazeSolvers[solver].solve(maze, path, nodesExplored);
+    if (mazeSolverUsesHierarchy(solver)) return queryMazeHierarchy(hierarchy, maze->start, maze->end, path, nodesExplored) >= 0;
+    return parallelBfsSolveMaze(maze, path, nodesExplored, threads);
+}
+
+// Generates a maze or loads one from a file, as the user chooses. The
+// seed is printed so a generated maze can be made again; for a weighted
+// solver it also seeds the terrain. A text maze can be saved as a binary
+// file, which later runs map instead of parsing. Returns 0 if the file
+// could not be loaded.
+int inputMaze(Maze* maze, int weighted) {
+    char prompt[64];
+    printf("Maze source: 1 = random walls, 2 = backtracker, 3 = Kruskal, 4 = Prim, 5 = Wilson, 6 = file\n");
+    int source = getIntegerInput("Enter maze source (1-6): ", 1, 6);
+    if (source < 6) {
+        snprintf(prompt, sizeof(prompt), "Enter maze width (5-%d): ", MAX_MAZE_SIZE);
+        int width = getIntegerInput(prompt, 5, MAX_MAZE_SIZE);
+        snprintf(prompt, sizeof(prompt), "Enter maze height (5-%d): ", MAX_MAZE_SIZE);
+        int height = getIntegerInput(prompt, 5, MAX_MAZE_SIZE);
+        float wallDensity = source == 1 ? getFloatInput("Enter wall density (0.1-0.4): ", 0.1, 0.4) : 0;
+        int maxWeight = 1;
+        if (weighted) {
+            snprintf(prompt, sizeof(prompt), "Enter highest terrain cost (1-%d): ", MAZE_MAX_WEIGHT);
+            maxWeight = getIntegerInput(prompt, 1, MAZE_MAX_WEIGHT);
         }
+        snprintf(prompt, sizeof(prompt), "Enter seed (0 = from the clock, up to %d): ", INT_MAX);
+        unsigned long long seed = (unsigned long long)getIntegerInput(prompt, 0, INT_MAX);
+        if (seed == 0) seed = (unsigned long long)monotonicNanos() % INT_MAX + 1;
+        
+        long long start = monotonicNanos();
+        generateSeededMaze(maze, width, height, source - 1, wallDensity, maxWeight, seed);
+        printf("Generated with seed %llu in %.4f seconds.\n", seed, (monotonicNanos() - start) / 1e9);
+        return 1;
     }
     
-    return 0;
+    char path[256];
+    getLineInput("Enter maze file: ", path, sizeof(path));
+    if (!loadMaze(maze, path)) return 0;
+    printf("Loaded %dx%d maze%s.\n", maze->width, maze->height, maze->mappedBytes ? " (memory-mapped)" : "");
+    if (!maze->mappedBytes) {
+        getLineInput("Save as binary maze file (blank to skip): ", path, sizeof(path));
+        if (path[0] != '\0') {
+            if (writeMazeFile(maze, path)) printf("Saved %s.\n", path);
+            else printf("Could not write %s!\n", path);
+        }
+    }
+    return 1;
 }
 
 // Main Maze Solver Function
 void solveMaze(int algorithm) {
-    int width = getIntegerInput("Enter maze width (5-20): ", 5, 20);
-    int height = getIntegerInput("Enter maze height (5-20): ", 5, 20);
-    float wallDensity = getFloatInput("Enter wall density (0.1-0.4): ", 0.1, 0.4);
-    
     Maze maze;
-    generateMaze(&maze, width, height, wallDensity);
+    if (!inputMaze(&maze, algorithm == 8 || algorithm == 9)) return;
+    char prompt[64];
+    int threads = 1;
+    if (algorithm == 7) {
+        snprintf(prompt, sizeof(prompt), "Enter worker threads (1-%d): ", MAX_MAZE_THREADS);
+        threads = getIntegerInput(prompt, 1, MAX_MAZE_THREADS);
+    }
     
-    MazePoint path[MAX_MAZE_SIZE * MAX_MAZE_SIZE];
-    int pathLength = 0;
-    int nodesExplored = 0;
+    int animate = algorithm == 1 && mazeAnimationAvailable() &&
+                  getIntegerInput("Animate the search frontier? (1 = yes, 0 = no): ", 0, 1);
+    
+    MazePath path = {NULL, 0};
+    long long nodesExplored = 0;
     
     printf("\n=== MAZE SOLVER ===\n");
     printf("Initial maze:\n");
-    printMaze(&maze, path, pathLength);
+    printMaze(&maze, &path);
     
-    clock_t start = clock();
+    // Wall time: clock() would add up the CPU time of every search thread.
+    long long start = monotonicNanos();
     int solved = 0;
     
-    if (algorithm == 1) {
-        printf("Solving using BFS...\n");
-        solved = bfsSolveMaze(&maze, path, &pathLength, &nodesExplored);
-    } else {
-        printf("Solving using DFS...\n");
-        solved = dfsSolveMaze(&maze, path, &pathLength, &nodesExplored);
+    switch (algorithm) {
+        case 1:
+            printf("Solving using BFS...\n");
+            solved = bfsSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 2:
+            printf("Solving using DFS...\n");
+            solved = dfsSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 3:
+            printf("Solving using A*...\n");
+            solved = aStarSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 4:
+            printf("Solving using Jump Point Search...\n");
+            solved = jpsSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 5:
+            printf("Solving using bidirectional BFS...\n");
+            solved = bidirectionalSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 7:
+            printf("Solving using parallel BFS on %d threads...\n", threads);
+            solved = parallelBfsSolveMaze(&maze, &path, &nodesExplored, threads);
+            break;
+        case 8:
+            printf("Solving using Dijkstra with a bucket queue...\n");
+            solved = dijkstraSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        case 9:
+            printf("Solving using weighted A*...\n");
+            solved = weightedAStarSolveMaze(&maze, &path, &nodesExplored);
+            break;
+        default:
+            printf("Solving using bit-parallel BFS (%s kernel)...\n", bitsetBfsKernelName());
+            solved = bitsetBfsSolveMaze(&maze, &path, &nodesExplored);
+            break;
     }
     
-    clock_t end = clock();
-    double timeTaken = ((double)(end - start)) / CLOCKS_PER_SEC;
+    double timeTaken = (monotonicNanos() - start) / 1e9;
     
     if (solved) {
-        printf("\nSolution found! Path length: %d\n", pathLength);
-        printf("Nodes explored: %d\n", nodesExplored);
+        printf("\nSolution found! Path length: %lld\n", path.length);
+        if (maze.weight != NULL) printf("Path cost: %lld\n", mazePathCost(&maze, &path));
+        printf("Nodes explored: %lld\n", nodesExplored);
         printf("Time taken: %.4f seconds\n", timeTaken);
+        if (animate) animateMazeBfs(&maze, &path);
         printf("\nSolution path:\n");
-        printMaze(&maze, path, pathLength);
+        printMaze(&maze, &path);
     } else {
         printf("\nNo solution found!\n");
-        printf("Nodes explored: %d\n", nodesExplored);
+        printf("Nodes explored: %lld\n", nodesExplored);
         printf("Time taken: %.4f seconds\n", timeTaken);
     }
+    
+    freeMazePath(&path);
+    freeMaze(&maze);
 }
\ No newline at end of file
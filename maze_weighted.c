@@ -0,0 +1,126 @@
+#include "ai_agent.h"
+
+// Weighted Maze Solvers
+// Stepping onto a cell costs its weight, 1 to MAZE_MAX_WEIGHT. Dijkstra
+// and A* here use Dial's bucket queue instead of a heap: a ring of
+// MAZE_MAX_WEIGHT + 2 stacks indexed by key modulo the ring size. Every
+// queued key lies between the key being expanded and that key plus
+// MAZE_MAX_WEIGHT + 1 (an A* step changes g by the weight and h by one),
+// so the ring never mixes two keys in one bucket, and pushes and pops are
+// O(1): the whole search is linear in the cells it touches plus the path
+// cost. Stale entries are left in the buckets and skipped when popped.
+
+#define DIAL_BUCKETS (MAZE_MAX_WEIGHT + 2)
+
+// Costs are kept modulo 2^32: the distances of cells still queued are
+// within DIAL_BUCKETS of each other, so a signed difference orders them
+// even past 4 billion, which the longest weighted mazes can reach.
+static int dialSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored, int informed) {
+    size_t words = mazeWords(maze);
+    unsigned int startCell = mazeIndex(maze, maze->start.x, maze->start.y);
+    unsigned int endCell = mazeIndex(maze, maze->end.x, maze->end.y);
+    MazeSearch search;
+    MazeStack buckets[DIAL_BUCKETS];
+    unsigned int* cost = (unsigned int*)malloc(words * 64 * sizeof(unsigned int));
+    unsigned long long* reached = (unsigned long long*)calloc(words, sizeof(unsigned long long));
+    if (cost == NULL || reached == NULL) {
+        printf("Memory allocation failed for maze search!\n");
+        exit(1);
+    }
+    int found = 0;
+    
+    initMazeSearch(&search, maze);
+    for (int b = 0; b < DIAL_BUCKETS; b++) initMazeStack(&buckets[b]);
+    unsigned long long key = informed ? mazeManhattan(maze, startCell, endCell) : 0;
+    cost[startCell] = 0;
+    setMazeBit(reached, startCell);
+    pushMaze(&buckets[key % DIAL_BUCKETS], startCell);
+    long long queued = 1;
+    *nodesExplored = 0;
+    
+    while (queued > 0) {
+        MazeStack* bucket = &buckets[key % DIAL_BUCKETS];
+        if (isMazeStackEmpty(bucket)) {
+            key++;
+            continue;
+        }
+        unsigned int current = popMaze(bucket);
+        queued--;
+        unsigned int h = informed ? mazeManhattan(maze, current, endCell) : 0;
+        if (!testMazeBit(search.unvisited, current) || cost[current] + h != (unsigned int)key) continue;
+        clearMazeBit(search.unvisited, current);
+        (*nodesExplored)++;
+        
+        if (current == endCell) {
+            buildMazePath(maze, &search, startCell, current, path);
+            found = 1;
+            break;
+        }
+        
+        int neighbours = mazeNeighbours(search.unvisited, current, maze->stride);
+        while (neighbours) {
+            int direction = __builtin_ctz(neighbours);
+            neighbours &= neighbours - 1;
+            unsigned int next = current + mazeStep(maze, direction);
+            unsigned int weight = mazeWeight(maze, next);
+            unsigned int nextCost = cost[current] + weight;
+            if (testMazeBit(reached, next) && (int)(nextCost - cost[next]) >= 0) continue;
+            cost[next] = nextCost;
+            setMazeBit(reached, next);
+            setParentDirection(&search, next, direction);
+            unsigned long long nextKey = key - h + weight + (informed ? mazeManhattan(maze, next, endCell) : 0);
+            pushMaze(&buckets[nextKey % DIAL_BUCKETS], next);
+            queued++;
+        }
+    }
+    
+    for (int b = 0; b < DIAL_BUCKETS; b++) freeMazeStack(&buckets[b]);
+    freeMazeSearch(&search);
+    free(reached);
+    free(cost);
+    return found;
+}
+
+int dijkstraSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    return dialSolveMaze(maze, path, nodesExplored, 0);
+}
+
+// Manhattan distance never overestimates, as every step costs at least 1.
+int weightedAStarSolveMaze(Maze* maze, MazePath* path, long long* nodesExplored) {
+    return dialSolveMaze(maze, path, nodesExplored, 1);
+}
+
+// Sum of the weights of the cells stepped onto, so the start is free.
+long long mazePathCost(const Maze* maze, const MazePath* path) {
+    long long total = 0;
+    for (long long i = 1; i < path->length; i++) total += mazeWeight(maze, path->cells[i]);
+    return total;
+}
+
+// Gives an allocated maze terrain in 8x8 patches of one random weight each,
+// from 1 to maxWeight. Start and end weigh 1, as the 'S' and 'E' of the
+// text notation do, so a weighted maze keeps its costs when written out
+// as text and read back.
+void addMazeTerrain(Maze* maze, int maxWeight, unsigned long long seed) {
+    size_t cells = mazeWords(maze) * 64;
+    int patches = (maze->width + 7) / 8;
+    maze->weight = (unsigned char*)malloc(cells);
+    unsigned char* patchWeight = (unsigned char*)malloc((size_t)patches);
+    if (maze->weight == NULL || patchWeight == NULL) {
+        printf("Memory allocation failed for maze terrain!\n");
+        exit(1);
+    }
+    memset(maze->weight, 1, cells);
+    
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (int i = 0; i < maze->height; i++) {
+        if (i % 8 == 0) {
+            for (int p = 0; p < patches; p++) patchWeight[p] = (unsigned char)(1 + rngBelow(&rng, maxWeight));
+        }
+        for (int j = 0; j < maze->width; j++) maze->weight[mazeIndex(maze, i, j)] = patchWeight[j / 8];
+    }
+    maze->weight[mazeIndex(maze, maze->start.x, maze->start.y)] = 1;
+    maze->weight[mazeIndex(maze, maze->end.x, maze->end.y)] = 1;
+    free(patchWeight);
+}
\ No newline at end of file
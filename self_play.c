@@ -0,0 +1,166 @@
+#include "ai_agent.h"
+
+// Headless Self-Play
+// Worker threads play batches of games on the configured board without
+// printing anything, each with its own random stream and search table.
+
+typedef struct {
+    const SelfPlayConfig* config;
+    long long firstGame, endGame;   // plays games [firstGame, endGame)
+    SelfPlayResult result;
+} SelfPlayWorker;
+
+// Move for player at level. The engine only searches for X, so O's moves
+// are chosen on the board with the colours exchanged.
+static Point chooseMove(Bitboard* board, int player, int level, TranspositionTable* tt, MctsTree* mcts, Rng* rng, long long* nodes) {
+    if (level == SELF_PLAY_RANDOM) {
+        Point moves[MAX_BOARD_CELLS];
+        int moveCount;
+        getAvailableMoves(board, moves, &moveCount);
+        return moves[rngBelow(rng, moveCount)];
+    }
+    
+    SearchStats stats;
+    if (player == -1) swapSides(board);
+    Point move = getAIMoveWithDifficulty(board, tt, mcts, &stats, level, rng);
+    if (player == -1) swapSides(board);
+    *nodes += stats.nodes;
+    return move;
+}
+
+// Even-numbered games are opened by X, odd ones by O.
+static void playSelfPlayGame(const SelfPlayConfig* config, long long game, TranspositionTable* tt, MctsTree trees[2], Rng* rng, SelfPlayResult* result) {
+    Bitboard board;
+    memset(&board, 0, sizeof(board));
+    int player = (game & 1) ? -1 : 1;
+    trees[0].used = trees[1].used = 0;
+    
+    while (1) {
+        int winner = checkWinner(&board);
+        if (winner != INT_MIN) {
+            if (winner == 1) result->xWins++;
+            else if (winner == -1) result->oWins++;
+            else result->draws++;
+            break;
+        }
+        
+        int level = player == 1 ? config->xLevel : config->oLevel;
+        Point move = chooseMove(&board, player, level, tt, &trees[player == 1 ? 0 : 1], rng, &result->nodes);
+        setCell(&board, move.x, move.y, player);
+        result->moves++;
+        player = -player;
+    }
+    result->games++;
+}
+
+static void* selfPlayWorker(void* arg) {
+    SelfPlayWorker* worker = (SelfPlayWorker*)arg;
+    // Allocated by the engine on the first move that needs a search; each
+    // side keeps its own Monte Carlo tree so it can be reused move to move.
+    TranspositionTable tt;
+    MctsTree trees[2];
+    memset(&tt, 0, sizeof(tt));
+    memset(trees, 0, sizeof(trees));
+    Rng rng;
+    
+    for (long long game = worker->firstGame; game < worker->endGame; game++) {
+        // Reseeding per game keeps results independent of the thread count.
+        rngSeed(&rng, worker->config->seed ^ ((unsigned long long)game * 0x9E3779B97F4A7C15ULL));
+        playSelfPlayGame(worker->config, game, &tt, trees, &rng, &worker->result);
+    }
+    freeTranspositionTable(&tt);
+    freeMctsTree(&trees[0]);
+    freeMctsTree(&trees[1]);
+    return NULL;
+}
+
+// Plays config->games games with the current engine configuration, split
+// evenly over config->threads workers, and sums their tallies into result.
+void runSelfPlay(const SelfPlayConfig* config, SelfPlayResult* result) {
+    initTicTacToeEngine();
+    int threads = config->threads < 1 ? 1 : config->threads;
+    if (threads > MAX_SELF_PLAY_THREADS) threads = MAX_SELF_PLAY_THREADS;
+    if (threads > config->games) threads = config->games > 0 ? (int)config->games : 1;
+    
+    SelfPlayWorker workers[MAX_SELF_PLAY_THREADS];
+    pthread_t handles[MAX_SELF_PLAY_THREADS];
+    long long start = monotonicNanos();
+    for (int t = 0; t < threads; t++) {
+        memset(&workers[t], 0, sizeof(SelfPlayWorker));
+        workers[t].config = config;
+        workers[t].firstGame = config->games * t / threads;
+        workers[t].endGame = config->games * (t + 1) / threads;
+    }
+    // The calling thread takes the first share itself.
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, selfPlayWorker, &workers[t]) != 0) {
+            printf("Failed to start self-play thread!\n");
+            exit(1);
+        }
+    }
+    selfPlayWorker(&workers[0]);
+    for (int t = 1; t < threads; t++) pthread_join(handles[t], NULL);
+    
+    memset(result, 0, sizeof(SelfPlayResult));
+    for (int t = 0; t < threads; t++) {
+        result->games += workers[t].result.games;
+        result->xWins += workers[t].result.xWins;
+        result->oWins += workers[t].result.oWins;
+        result->draws += workers[t].result.draws;
+        result->moves += workers[t].result.moves;
+        result->nodes += workers[t].result.nodes;
+    }
+    result->seconds = (monotonicNanos() - start) / 1e9;
+}
+
+// Plays every difficulty as X against a random mover and each difficulty
+// as O, and prints throughput and results for each pairing.
+void playSelfPlaySimulator() {
+    printf("\n=== TIC-TAC-TOE SELF-PLAY SIMULATOR ===\n");
+    TicTacToeConfig engine;
+    getTicTacToeConfig(&engine);
+    engine.size = getIntegerInput("Enter board size (3-15): ", 3, MAX_BOARD_SIZE);
+    char prompt[64];
+    snprintf(prompt, sizeof(prompt), "Enter stones in a row to win (3-%d): ", engine.size);
+    engine.winLength = getIntegerInput(prompt, 3, engine.size);
+    engine.moveTimeMs = DEFAULT_MOVE_TIME_MS;
+    if (engine.size > 3) {
+        engine.moveTimeMs = getIntegerInput("Enter AI time per move in ms (1-10000): ", 1, 10000);
+        engine.searchEngine = getIntegerInput("Hard AI engine (1 = alpha-beta, 2 = MCTS): ", 1, 2) == 1 ? SEARCH_ALPHA_BETA : SEARCH_MCTS;
+    }
+    engine.maxDepth = 0;
+    engine.threads = 1;         // parallelism comes from playing games concurrently
+    engine.verbose = 0;
+    
+    SelfPlayConfig config;
+    config.games = getIntegerInput("Enter games per pairing (1-100000000): ", 1, 100000000);
+    snprintf(prompt, sizeof(prompt), "Enter worker threads (1-%d): ", MAX_SELF_PLAY_THREADS);
+    config.threads = getIntegerInput(prompt, 1, MAX_SELF_PLAY_THREADS);
+    config.seed = (unsigned long long)getIntegerInput("Enter random seed (0 = from clock): ", 0, INT_MAX);
+    if (config.seed == 0) config.seed = (unsigned long long)monotonicNanos();
+    
+    TicTacToeConfig saved;
+    getTicTacToeConfig(&saved);
+    configureTicTacToe(&engine);
+    
+    char* levelNames[] = {"Random", "Easy", "Medium", "Hard"};
+    printf("\n%dx%d board, %d in a row, %lld games per pairing, %d threads, seed %llu\n",
+           engine.size, engine.size, engine.winLength, config.games, config.threads, config.seed);
+    printf("%-8s %-8s %12s %12s %8s %8s %8s\n", "X", "O", "Games", "Games/s", "X win", "Draw", "O win");
+    for (int xLevel = 1; xLevel <= 3; xLevel++) {
+        for (int oLevel = SELF_PLAY_RANDOM; oLevel <= 3; oLevel++) {
+            SelfPlayResult result;
+            config.xLevel = xLevel;
+            config.oLevel = oLevel;
+            runSelfPlay(&config, &result);
+            
+            double games = (double)result.games;
+            printf("%-8s %-8s %12lld %12.0f %7.2f%% %7.2f%% %7.2f%%\n",
+                   levelNames[xLevel], levelNames[oLevel], result.games,
+                   result.seconds > 0 ? games / result.seconds : 0,
+                   100.0 * result.xWins / games, 100.0 * result.draws / games, 100.0 * result.oWins / games);
+        }
+    }
+    
+    configureTicTacToe(&saved);
+}
\ No newline at end of file
@@ -1,288 +1,1654 @@
 #include "ai_agent.h"
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-// Tic-Tac-Toe Helper Functions
-void initMemoTable(MemoTable* table, int size) {
-    table->size = size;
-    table->count = 0;
-    table->table = (MemoEntry**)calloc(size, sizeof(MemoEntry*));
-    if (table->table == NULL) {
-        printf("Memory allocation failed for memo table!\n");
-        exit(1);
+// Engine State
+// One board geometry is active at a time; configureTicTacToe() rebuilds
+// every table below for it.
+static TicTacToeConfig engineConfig;
+static int boardCells;
+static BoardMask fullBoardMask;
+static BoardMask notFirstColumn, notLastColumn;
+
+// Every winLength window on the board, plus for each cell the windows
+// that pass through it (cellLines[cellLineStart[c] .. cellLineStart[c+1]]).
+static BoardMask winMasks[MAX_WIN_LINES];
+static int numWinLines;
+static short cellLineStart[MAX_BOARD_CELLS + 1];
+static short cellLines[MAX_BOARD_CELLS * 4 * MAX_BOARD_SIZE];
+static int lineWeights[MAX_BOARD_SIZE + 1];
+
+static int centreBonus[MAX_BOARD_CELLS];
+
+static unsigned char symCell[NUM_SYMMETRIES][MAX_BOARD_CELLS];
+static unsigned char symInverse[NUM_SYMMETRIES][MAX_BOARD_CELLS];
+static unsigned long long zobristKeys[2][MAX_BOARD_CELLS];
+// symZobrist[side][cell][s] is the key of cell after applying symmetry s.
+static unsigned long long symZobrist[2][MAX_BOARD_CELLS][NUM_SYMMETRIES];
+static unsigned long long zobristSideKey;
+static int zobristReady = 0;
+static int engineReady = 0;
+
+static void loadPerfectPlayTable(const char* path);
+
+// Bitboard Helpers
+static inline int popCount(const BoardMask* m) {
+    int count = 0;
+    for (int i = 0; i < BOARD_WORDS; i++) count += __builtin_popcountll(m->w[i]);
+    return count;
+}
+
+static inline int maskIsEmpty(const BoardMask* m) {
+    unsigned long long any = 0;
+    for (int i = 0; i < BOARD_WORDS; i++) any |= m->w[i];
+    return any == 0;
+}
+
+static inline int maskTest(const BoardMask* m, int cell) {
+    return (int)((m->w[cell >> 6] >> (cell & 63)) & 1);
+}
+
+static inline void maskSet(BoardMask* m, int cell) {
+    m->w[cell >> 6] |= 1ULL << (cell & 63);
+}
+
+static inline void maskFlip(BoardMask* m, int cell) {
+    m->w[cell >> 6] ^= 1ULL << (cell & 63);
+}
+
+static inline BoardMask maskAnd(BoardMask a, BoardMask b) {
+    for (int i = 0; i < BOARD_WORDS; i++) a.w[i] &= b.w[i];
+    return a;
+}
+
+static inline BoardMask maskOr(BoardMask a, BoardMask b) {
+    for (int i = 0; i < BOARD_WORDS; i++) a.w[i] |= b.w[i];
+    return a;
+}
+
+// a fully contains b
+static inline int maskCovers(const BoardMask* a, const BoardMask* b) {
+    unsigned long long missing = 0;
+    for (int i = 0; i < BOARD_WORDS; i++) missing |= b->w[i] & ~a->w[i];
+    return missing == 0;
+}
+
+// Moves every bit n (< 64) cells towards higher indices.
+static inline BoardMask maskShiftUp(BoardMask m, int n) {
+    BoardMask r;
+    for (int i = BOARD_WORDS - 1; i > 0; i--) {
+        r.w[i] = (m.w[i] << n) | (m.w[i - 1] >> (64 - n));
     }
+    r.w[0] = m.w[0] << n;
+    return r;
 }
 
-unsigned int hashString(const char* str) {
-    unsigned int hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c;
+// Moves every bit n (< 64) cells towards lower indices.
+static inline BoardMask maskShiftDown(BoardMask m, int n) {
+    BoardMask r;
+    for (int i = 0; i < BOARD_WORDS - 1; i++) {
+        r.w[i] = (m.w[i] >> n) | (m.w[i + 1] << (64 - n));
     }
-    return hash;
+    r.w[BOARD_WORDS - 1] = m.w[BOARD_WORDS - 1] >> n;
+    return r;
 }
 
-void memoInsert(MemoTable* table, const char* key, int score, int move_i, int move_j) {
-    unsigned int index = hashString(key) % table->size;
-    MemoEntry* newEntry = (MemoEntry*)malloc(sizeof(MemoEntry));
-    if (newEntry == NULL) {
-        printf("Memory allocation failed for memo entry!\n");
-        return;
+// Writes the set cells in ascending order; returns how many there are.
+static inline int maskToCells(const BoardMask* m, int cells[]) {
+    int count = 0;
+    for (int i = 0; i < BOARD_WORDS; i++) {
+        unsigned long long bits = m->w[i];
+        while (bits) {
+            cells[count++] = (i << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
+
+static inline BoardMask emptySquares(const Bitboard* board) {
+    BoardMask empty;
+    for (int i = 0; i < BOARD_WORDS; i++) {
+        empty.w[i] = ~(board->x.w[i] | board->o.w[i]) & fullBoardMask.w[i];
+    }
+    return empty;
+}
+
+static unsigned long long splitMix64(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Symmetry s rotates the board 90 degrees (s & 3) times, then mirrors
+// the columns when s & 4 is set.
+static int transformCell(int s, int cell) {
+    int size = engineConfig.size;
+    int row = cell / size, col = cell % size;
+    for (int r = 0; r < (s & 3); r++) {
+        int t = row;
+        row = col;
+        col = size - 1 - t;
+    }
+    if (s & 4) col = size - 1 - col;
+    return row * size + col;
+}
+
+static void buildWinLines() {
+    int size = engineConfig.size, k = engineConfig.winLength;
+    int directions[4][2] = {{0,1}, {1,0}, {1,1}, {1,-1}};
+    int lineCount[MAX_BOARD_CELLS] = {0};
+    
+    numWinLines = 0;
+    for (int d = 0; d < 4; d++) {
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                int endRow = row + directions[d][0] * (k - 1);
+                int endCol = col + directions[d][1] * (k - 1);
+                if (endRow >= size || endCol < 0 || endCol >= size) continue;
+                
+                BoardMask line = {{0}};
+                for (int i = 0; i < k; i++) {
+                    maskSet(&line, (row + directions[d][0] * i) * size + col + directions[d][1] * i);
+                }
+                winMasks[numWinLines++] = line;
+            }
+        }
+    }
+    
+    for (int l = 0; l < numWinLines; l++) {
+        for (int cell = 0; cell < boardCells; cell++) {
+            if (maskTest(&winMasks[l], cell)) lineCount[cell]++;
+        }
+    }
+    cellLineStart[0] = 0;
+    for (int cell = 0; cell < boardCells; cell++) {
+        cellLineStart[cell + 1] = (short)(cellLineStart[cell] + lineCount[cell]);
+        lineCount[cell] = cellLineStart[cell];
+    }
+    for (int l = 0; l < numWinLines; l++) {
+        for (int cell = 0; cell < boardCells; cell++) {
+            if (maskTest(&winMasks[l], cell)) cellLines[lineCount[cell]++] = (short)l;
+        }
     }
     
-    strcpy(newEntry->key, key);
-    newEntry->score = score;
-    newEntry->move_i = move_i;
-    newEntry->move_j = move_j;
-    newEntry->next = table->table[index];
-    table->table[index] = newEntry;
-    table->count++;
+    // A window holding n stones of one side and none of the other is
+    // worth 8^(n-1); a completed window is a win and scored separately.
+    lineWeights[0] = 0;
+    for (int n = 1; n <= k; n++) {
+        lineWeights[n] = n >= 6 ? lineWeights[n - 1] : 1 << (3 * (n - 1));
+    }
+}
+
+static void initZobristKeys() {
+    // Fixed seed so hashes (and therefore search traces) are reproducible.
+    unsigned long long seed = 0x5EED7AC70EULL;
+    for (int cell = 0; cell < MAX_BOARD_CELLS; cell++) {
+        zobristKeys[0][cell] = splitMix64(&seed);
+        zobristKeys[1][cell] = splitMix64(&seed);
+    }
+    zobristSideKey = splitMix64(&seed);
+    zobristReady = 1;
 }
 
-int memoLookup(MemoTable* table, const char* key, int* move_i, int* move_j) {
-    unsigned int index = hashString(key) % table->size;
-    MemoEntry* entry = table->table[index];
+// Switches the engine to an N x N board with K in a row; safe to call
+// repeatedly. Transposition tables from another geometry must be cleared.
+void configureTicTacToe(const TicTacToeConfig* config) {
+    if (!zobristReady) initZobristKeys();
+    engineConfig = *config;
+    int size = engineConfig.size;
+    boardCells = size * size;
     
-    while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
-            if (move_i) *move_i = entry->move_i;
-            if (move_j) *move_j = entry->move_j;
-            return entry->score;
+    memset(&fullBoardMask, 0, sizeof(fullBoardMask));
+    memset(&notFirstColumn, 0, sizeof(notFirstColumn));
+    memset(&notLastColumn, 0, sizeof(notLastColumn));
+    for (int cell = 0; cell < boardCells; cell++) {
+        maskSet(&fullBoardMask, cell);
+        if (cell % size != 0) maskSet(&notFirstColumn, cell);
+        if (cell % size != size - 1) maskSet(&notLastColumn, cell);
+        
+        // Doubled so even boards, whose centre falls between squares,
+        // still rank the four middle squares equally.
+        int rowDistance = abs(2 * (cell / size) - (size - 1));
+        int colDistance = abs(2 * (cell % size) - (size - 1));
+        centreBonus[cell] = 2 * (size - 1) - (rowDistance > colDistance ? rowDistance : colDistance);
+    }
+    
+    buildWinLines();
+    
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        for (int cell = 0; cell < boardCells; cell++) {
+            symCell[s][cell] = (unsigned char)transformCell(s, cell);
+            symInverse[s][symCell[s][cell]] = (unsigned char)cell;
         }
-        entry = entry->next;
     }
-    return INT_MIN;
+    for (int side = 0; side < 2; side++) {
+        for (int cell = 0; cell < boardCells; cell++) {
+            for (int s = 0; s < NUM_SYMMETRIES; s++) {
+                symZobrist[side][cell][s] = zobristKeys[side][symCell[s][cell]];
+            }
+        }
+    }
+    
+    if (size == 3 && engineConfig.winLength == 3) {
+        loadPerfectPlayTable(PERFECT_TABLE_FILE);
+    }
+    engineReady = 1;
+}
+
+// Selects the classic 3x3 game if no geometry has been configured yet;
+// safe to call repeatedly.
+void initTicTacToeEngine() {
+    if (engineReady) return;
+    
+    TicTacToeConfig classic = {3, 3, DEFAULT_MOVE_TIME_MS, 0, 1, PARALLEL_LAZY_SMP, 1, SEARCH_ALPHA_BETA};
+    configureTicTacToe(&classic);
+}
+
+void getTicTacToeConfig(TicTacToeConfig* config) {
+    initTicTacToeEngine();
+    *config = engineConfig;
+}
+
+static inline int hasWinningLine(const BoardMask* side) {
+    for (int i = 0; i < numWinLines; i++) {
+        if (maskCovers(side, &winMasks[i])) return 1;
+    }
+    return 0;
+}
+
+// Only windows through the square just played can have been completed.
+static inline int completesLine(const BoardMask* side, int cell) {
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        if (maskCovers(side, &winMasks[cellLines[i]])) return 1;
+    }
+    return 0;
+}
+
+// Static score from X's point of view for positions at the depth limit:
+// open windows each side could still complete, weighted by how full
+// they are.
+static int evaluateBoard(const Bitboard* board) {
+    int score = 0;
+    for (int i = 0; i < numWinLines; i++) {
+        const BoardMask* line = &winMasks[i];
+        int xCount = 0, oCount = 0;
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            xCount += __builtin_popcountll(board->x.w[w] & line->w[w]);
+            oCount += __builtin_popcountll(board->o.w[w] & line->w[w]);
+        }
+        if (oCount == 0) score += lineWeights[xCount];
+        else if (xCount == 0) score -= lineWeights[oCount];
+    }
+    if (score > WIN_SCORE / 2) score = WIN_SCORE / 2;
+    if (score < -WIN_SCORE / 2) score = -WIN_SCORE / 2;
+    return score;
+}
+
+// Flips one square for player (1 = X, -1 = O); applying it twice undoes it.
+static inline void toggleCell(Bitboard* board, int cell, int player) {
+    const unsigned long long* keys;
+    if (player == 1) {
+        maskFlip(&board->x, cell);
+        keys = symZobrist[0][cell];
+    } else {
+        maskFlip(&board->o, cell);
+        keys = symZobrist[1][cell];
+    }
+    for (int s = 0; s < NUM_SYMMETRIES; s++) {
+        board->keys[s] ^= keys[s];
+    }
+}
+
+// Smallest of the per-symmetry keys; *sym receives the symmetry that maps
+// the position onto its canonical form.
+static inline unsigned long long canonicalKey(const Bitboard* board, int* sym) {
+    unsigned long long best = board->keys[0];
+    *sym = 0;
+    for (int s = 1; s < NUM_SYMMETRIES; s++) {
+        if (board->keys[s] < best) {
+            best = board->keys[s];
+            *sym = s;
+        }
+    }
+    return best;
+}
+
+// Squares worth searching. Small boards use every empty square; on larger
+// boards only squares touching a stone (or the centre of an empty board)
+// are candidates, which keeps the branching factor near the stone count.
+static BoardMask candidateSquares(const Bitboard* board, BoardMask empty) {
+    if (boardCells <= 16) return empty;
+    
+    BoardMask stones = maskOr(board->x, board->o);
+    if (maskIsEmpty(&stones)) {
+        BoardMask centre = {{0}};
+        maskSet(&centre, (engineConfig.size / 2) * engineConfig.size + engineConfig.size / 2);
+        return centre;
+    }
+    
+    int size = engineConfig.size;
+    BoardMask east = maskShiftUp(maskAnd(stones, notLastColumn), 1);
+    BoardMask west = maskShiftDown(maskAnd(stones, notFirstColumn), 1);
+    BoardMask row = maskOr(stones, maskOr(east, west));
+    BoardMask near = maskOr(row, maskOr(maskShiftUp(row, size), maskShiftDown(row, size)));
+    return maskAnd(near, empty);
+}
+
+// Candidate squares with one representative per orbit of the symmetries
+// that leave the position unchanged; moves in the same orbit score the
+// same. Returns the number of moves written.
+static int distinctMoves(const Bitboard* board, BoardMask empty, int moves[]) {
+    BoardMask candidates = candidateSquares(board, empty);
+    int count = maskToCells(&candidates, moves);
+    
+    int stabilizer[NUM_SYMMETRIES];
+    int symmetries = 0;
+    for (int s = 1; s < NUM_SYMMETRIES; s++) {
+        if (board->keys[s] == board->keys[0]) stabilizer[symmetries++] = s;
+    }
+    if (symmetries == 0) return count;
+    
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        int cell = moves[i];
+        int representative = 1;
+        for (int j = 0; j < symmetries; j++) {
+            if (symCell[stabilizer[j]][cell] < cell) {
+                representative = 0;
+                break;
+            }
+        }
+        if (representative) moves[distinct++] = cell;
+    }
+    return distinct;
+}
+
+int getCell(const Bitboard* board, int row, int col) {
+    int cell = row * engineConfig.size + col;
+    if (maskTest(&board->x, cell)) return 1;
+    if (maskTest(&board->o, cell)) return -1;
+    return 0;
+}
+
+void setCell(Bitboard* board, int row, int col, int player) {
+    int cell = row * engineConfig.size + col;
+    int current = getCell(board, row, col);
+    if (current != 0) toggleCell(board, cell, current);
+    if (player != 0) toggleCell(board, cell, player);
+}
+
+// Exchanges X and O, so a search that only plays X can move for O.
+void swapSides(Bitboard* board) {
+    BoardMask stones = maskOr(board->x, board->o);
+    int cells[MAX_BOARD_CELLS];
+    int count = maskToCells(&stones, cells);
+    for (int i = 0; i < count; i++) {
+        for (int s = 0; s < NUM_SYMMETRIES; s++) {
+            board->keys[s] ^= symZobrist[0][cells[i]][s] ^ symZobrist[1][cells[i]][s];
+        }
+    }
+    BoardMask x = board->x;
+    board->x = board->o;
+    board->o = x;
+}
+
+// Transposition Table Functions
+void initTranspositionTable(TranspositionTable* tt, int sizeLog2) {
+    tt->size = 1u << sizeLog2;
+    tt->mask = tt->size - 1;
+    tt->count = 0;
+    tt->age = 0;
+    tt->slots = (TTSlot*)calloc(tt->size, sizeof(TTSlot));
+    if (tt->slots == NULL) {
+        printf("Memory allocation failed for transposition table!\n");
+        exit(1);
+    }
+}
+
+void clearTranspositionTable(TranspositionTable* tt) {
+    if (tt->slots != NULL) memset(tt->slots, 0, tt->size * sizeof(TTSlot));
+    tt->count = 0;
 }
 
-void printBoard(int board[BOARD_SIZE][BOARD_SIZE]) {
-    printf("\n   0   1   2\n");
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        printf("%d ", i);
-        for (int j = 0; j < BOARD_SIZE; j++) {
+void freeTranspositionTable(TranspositionTable* tt) {
+    free(tt->slots);
+    tt->slots = NULL;
+    tt->size = tt->mask = 0;
+    tt->count = 0;
+}
+
+// Win/loss scores count plies from the search root. Entries store them
+// relative to the node instead, so a hit at a different ply stays exact.
+// Heuristic scores never get near WIN_THRESHOLD and are stored as is.
+#define WIN_THRESHOLD (WIN_SCORE - MAX_BOARD_CELLS - 1)
+
+static inline int scoreToTT(int score, int ply) {
+    if (score >= WIN_THRESHOLD) return score + ply;
+    if (score <= -WIN_THRESHOLD) return score - ply;
+    return score;
+}
+
+static inline int scoreFromTT(int score, int ply) {
+    if (score >= WIN_THRESHOLD) return score - ply;
+    if (score <= -WIN_THRESHOLD) return score + ply;
+    return score;
+}
+
+// data layout: score:16 | bestMove:16 | depth:8 | flag:8 | age:8
+static inline unsigned long long packEntry(int score, int bestMove, int depth, int flag, int age) {
+    return (unsigned long long)(unsigned short)score |
+           (unsigned long long)(unsigned short)bestMove << 16 |
+           (unsigned long long)(unsigned char)depth << 32 |
+           (unsigned long long)(unsigned char)flag << 40 |
+           (unsigned long long)(unsigned char)age << 48;
+}
+
+static inline void unpackEntry(unsigned long long data, TTEntry* entry) {
+    entry->score = (short)(data & 0xFFFF);
+    entry->bestMove = (short)((data >> 16) & 0xFFFF);
+    entry->depth = (int)((data >> 32) & 0xFF);
+    entry->flag = (int)((data >> 40) & 0xFF);
+    entry->age = (int)((data >> 48) & 0xFF);
+}
+
+static inline TTSlot* ttBucket(TranspositionTable* tt, unsigned long long key) {
+    return &tt->slots[(unsigned int)key & tt->mask & ~(unsigned int)(TT_BUCKET_SIZE - 1)];
+}
+
+// Copies the entry for key into *entry; returns 0 if there is none.
+// Returns TT_HIT and fills *entry, or TT_MISS / TT_COLLISION.
+int ttProbe(TranspositionTable* tt, unsigned long long key, TTEntry* entry) {
+    TTSlot* bucket = ttBucket(tt, key);
+    int occupied = 0;
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        unsigned long long data = __atomic_load_n(&bucket[i].data, __ATOMIC_RELAXED);
+        unsigned long long check = __atomic_load_n(&bucket[i].check, __ATOMIC_RELAXED);
+        if ((check ^ data) == key && data != 0) {
+            unpackEntry(data, entry);
+            return TT_HIT;
+        }
+        if (data != 0) occupied++;
+    }
+    return occupied == TT_BUCKET_SIZE ? TT_COLLISION : TT_MISS;
+}
+
+void ttStore(TranspositionTable* tt, unsigned long long key, int depth, int score, int flag, int bestMove) {
+    TTSlot* bucket = ttBucket(tt, key);
+    TTSlot* victim = NULL;
+    unsigned long long victimData = 0;
+    int victimValue = INT_MAX;
+    
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        unsigned long long data = __atomic_load_n(&bucket[i].data, __ATOMIC_RELAXED);
+        unsigned long long check = __atomic_load_n(&bucket[i].check, __ATOMIC_RELAXED);
+        if (data == 0 || (check ^ data) == key) {
+            victim = &bucket[i];
+            victimData = data;
+            break;
+        }
+        // Evict entries from older searches first, then the shallowest draft.
+        TTEntry entry;
+        unpackEntry(data, &entry);
+        int value = entry.depth - 4 * (unsigned char)(tt->age - entry.age);
+        if (value < victimValue) {
+            victimValue = value;
+            victim = &bucket[i];
+            victimData = data;
+        }
+    }
+    
+    if (victimData == 0) __atomic_fetch_add(&tt->count, 1, __ATOMIC_RELAXED);
+    unsigned long long data = packEntry(score, bestMove, depth, flag, tt->age);
+    __atomic_store_n(&victim->data, data, __ATOMIC_RELAXED);
+    __atomic_store_n(&victim->check, key ^ data, __ATOMIC_RELAXED);
+}
+
+void printBoard(const Bitboard* board) {
+    int size = engineConfig.size;
+    int labelWidth = size > 10 ? 2 : 1;
+    
+    printf("\n%*s", labelWidth + 2, "");
+    for (int j = 0; j < size; j++) {
+        if (j < size - 1) printf("%-4d", j);
+        else printf("%d", j);
+    }
+    printf("\n");
+    for (int i = 0; i < size; i++) {
+        printf("%*d ", labelWidth, i);
+        for (int j = 0; j < size; j++) {
             char symbol = ' ';
-            if (board[i][j] == 1) symbol = 'X';
-            else if (board[i][j] == -1) symbol = 'O';
+            int cell = getCell(board, i, j);
+            if (cell == 1) symbol = 'X';
+            else if (cell == -1) symbol = 'O';
             
             printf(" %c ", symbol);
-            if (j < BOARD_SIZE - 1) printf("|");
+            if (j < size - 1) printf("|");
         }
         printf("\n");
-        if (i < BOARD_SIZE - 1) {
-            printf("  ---+---+---\n");
+        if (i < size - 1) {
+            printf("%*s", labelWidth + 1, "");
+            for (int j = 0; j < size; j++) {
+                printf(j < size - 1 ? "---+" : "---\n");
+            }
         }
     }
     printf("\n");
 }
 
-int checkWinner(int board[BOARD_SIZE][BOARD_SIZE]) {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        int rowSum = 0, colSum = 0;
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            rowSum += board[i][j];
-            colSum += board[j][i];
+int checkWinner(const Bitboard* board) {
+    if (hasWinningLine(&board->x)) return 1;
+    if (hasWinningLine(&board->o)) return -1;
+    BoardMask empty = emptySquares(board);
+    if (maskIsEmpty(&empty)) return 0;
+    return INT_MIN;
+}
+
+void getAvailableMoves(const Bitboard* board, Point moves[], int* count) {
+    BoardMask empty = emptySquares(board);
+    int cells[MAX_BOARD_CELLS];
+    *count = maskToCells(&empty, cells);
+    for (int i = 0; i < *count; i++) {
+        moves[i].x = cells[i] / engineConfig.size;
+        moves[i].y = cells[i] % engineConfig.size;
+    }
+}
+
+// Move Ordering
+#define ORDER_TT_MOVE (1 << 30)
+#define ORDER_KILLER (1 << 29)
+
+// Static ordering score: squares that extend our open windows or block
+// the opponent's, weighted like evaluateBoard(), with a pull to the centre.
+static int threatScore(const Bitboard* board, int cell, int isMaximizing) {
+    const BoardMask* own = isMaximizing ? &board->x : &board->o;
+    const BoardMask* other = isMaximizing ? &board->o : &board->x;
+    int score = centreBonus[cell];
+    
+    for (int i = cellLineStart[cell]; i < cellLineStart[cell + 1]; i++) {
+        const BoardMask* line = &winMasks[cellLines[i]];
+        int ownCount = 0, otherCount = 0;
+        for (int w = 0; w < BOARD_WORDS; w++) {
+            ownCount += __builtin_popcountll(own->w[w] & line->w[w]);
+            otherCount += __builtin_popcountll(other->w[w] & line->w[w]);
+        }
+        if (otherCount == 0) score += lineWeights[ownCount + 1];
+        else if (ownCount == 0) score += lineWeights[otherCount + 1];
+    }
+    return score;
+}
+
+// Sorts moves best-first: the transposition table move, then this ply's
+// killers, then history credit plus threatScore(). Ties keep square order.
+static void orderMoves(const Bitboard* board, int moves[], int count, int ttMove, int depth, int isMaximizing, const SearchContext* search) {
+    int scores[MAX_BOARD_CELLS];
+    const int* history = search->history[isMaximizing ? 0 : 1];
+    
+    for (int i = 0; i < count; i++) {
+        int cell = moves[i];
+        if (cell == ttMove) scores[i] = ORDER_TT_MOVE;
+        else if (cell == search->killers[depth][0]) scores[i] = ORDER_KILLER + 1;
+        else if (cell == search->killers[depth][1]) scores[i] = ORDER_KILLER;
+        else scores[i] = history[cell] + threatScore(board, cell, isMaximizing);
+    }
+    
+    for (int i = 1; i < count; i++) {
+        int cell = moves[i], score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        moves[j + 1] = cell;
+        scores[j + 1] = score;
+    }
+}
+
+static void recordCutoff(SearchContext* search, int cell, int depth, int draft, int isMaximizing, int ttMove) {
+    int* history = &search->history[isMaximizing ? 0 : 1][cell];
+    *history += draft * draft;
+    if (*history > ORDER_KILLER / 2) {
+        // Keep history below the killer band by halving every square.
+        for (int side = 0; side < 2; side++) {
+            for (int c = 0; c < boardCells; c++) search->history[side][c] /= 2;
         }
-        if (abs(rowSum) == BOARD_SIZE) return board[i][0];
-        if (abs(colSum) == BOARD_SIZE) return board[0][i];
     }
     
-    int diag1 = board[0][0] + board[1][1] + board[2][2];
-    int diag2 = board[0][2] + board[1][1] + board[2][0];
+    if (cell != ttMove && cell != search->killers[depth][0]) {
+        search->killers[depth][1] = search->killers[depth][0];
+        search->killers[depth][0] = (short)cell;
+    }
+}
+
+// Depth-limited alpha-beta with principal variation search: the first
+// (best-ordered) move gets the full window, the rest a null window that
+// is widened only if they turn out to be better. depth counts plies from
+// the root, draft is how many more plies to search before falling back
+// to evaluateBoard(). The caller has already checked that the last move
+// did not win.
+int minimax(Bitboard* board, int depth, int draft, int isMaximizing, int alpha, int beta, SearchContext* search) {
+    SearchStats* stats = &search->stats;
+    stats->nodes++;
+    stats->nodesAtPly[depth]++;
+    if ((stats->nodes & 1023) == 0) {
+        if (monotonicNanos() >= search->deadline ||
+            (search->sharedStop != NULL && __atomic_load_n(search->sharedStop, __ATOMIC_RELAXED))) {
+            search->stopped = 1;
+        }
+    }
+    if (search->stopped) return 0;
+    
+    BoardMask empty = emptySquares(board);
+    if (maskIsEmpty(&empty)) return 0;
+    if (draft == 0) return evaluateBoard(board);
     
-    if (abs(diag1) == BOARD_SIZE) return board[0][0];
-    if (abs(diag2) == BOARD_SIZE) return board[0][2];
+    int sym;
+    unsigned long long key = canonicalKey(board, &sym) ^ (isMaximizing ? 0 : zobristSideKey);
+    int origAlpha = alpha, origBeta = beta;
+    int ttMove = -1;
     
-    int emptyCount = 0;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            if (board[i][j] == 0) emptyCount++;
+    TTEntry entry;
+    int probe = ttProbe(search->tt, key, &entry);
+    stats->ttProbes++;
+    if (probe == TT_COLLISION) stats->ttCollisions++;
+    if (probe == TT_HIT) {
+        stats->ttHits++;
+        if (entry.bestMove >= 0) ttMove = symInverse[sym][entry.bestMove];
+        if (entry.depth >= draft) {
+            int cachedScore = scoreFromTT(entry.score, depth);
+            if (entry.flag == TT_EXACT) return cachedScore;
+            if (entry.flag == TT_LOWER && cachedScore > alpha) alpha = cachedScore;
+            if (entry.flag == TT_UPPER && cachedScore < beta) beta = cachedScore;
+            if (beta <= alpha) return cachedScore;
         }
     }
-    if (emptyCount == 0) return 0;
     
-    return INT_MIN;
+    int player = isMaximizing ? 1 : -1;
+    const BoardMask* side = isMaximizing ? &board->x : &board->o;
+    int bestScore = isMaximizing ? INT_MIN : INT_MAX;
+    int bestCell = -1;
+    int moves[MAX_BOARD_CELLS];
+    int moveCount = distinctMoves(board, empty, moves);
+    orderMoves(board, moves, moveCount, ttMove, depth, isMaximizing, search);
+    stats->expandedNodes++;
+    
+    for (int i = 0; i < moveCount; i++) {
+        int cell = moves[i];
+        int score;
+        
+        stats->movesSearched++;
+        toggleCell(board, cell, player);
+        if (completesLine(side, cell)) {
+            score = player * (WIN_SCORE - (depth + 1));
+        } else if (i == 0) {
+            score = minimax(board, depth + 1, draft - 1, !isMaximizing, alpha, beta, search);
+        } else if (isMaximizing) {
+            score = minimax(board, depth + 1, draft - 1, 0, alpha, alpha + 1, search);
+            if (score > alpha && score < beta) {
+                score = minimax(board, depth + 1, draft - 1, 0, alpha, beta, search);
+            }
+        } else {
+            score = minimax(board, depth + 1, draft - 1, 1, beta - 1, beta, search);
+            if (score < beta && score > alpha) {
+                score = minimax(board, depth + 1, draft - 1, 1, alpha, beta, search);
+            }
+        }
+        toggleCell(board, cell, player);
+        if (search->stopped) return 0;
+        
+        if (isMaximizing) {
+            if (score > bestScore) {
+                bestScore = score;
+                bestCell = cell;
+            }
+            if (score > alpha) alpha = score;
+        } else {
+            if (score < bestScore) {
+                bestScore = score;
+                bestCell = cell;
+            }
+            if (score < beta) beta = score;
+        }
+        if (beta <= alpha) {
+            stats->cutoffs++;
+            if (i == 0) stats->firstMoveCutoffs++;
+            recordCutoff(search, cell, depth, draft, isMaximizing, ttMove);
+            break;
+        }
+    }
+    
+    int flag = TT_EXACT;
+    if (bestScore <= origAlpha) flag = TT_UPPER;
+    else if (bestScore >= origBeta) flag = TT_LOWER;
+    ttStore(search->tt, key, draft, scoreToTT(bestScore, depth), flag, symCell[sym][bestCell]);
+    return bestScore;
 }
 
-void getAvailableMoves(int board[BOARD_SIZE][BOARD_SIZE], Point moves[], int* count) {
-    *count = 0;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            if (board[i][j] == 0) {
-                moves[*count].x = i;
-                moves[*count].y = j;
-                (*count)++;
+// One root pass for X over moves (already ordered) within (alpha, beta),
+// using the same PVS scheme as minimax. Returns the fail-soft best score.
+static int searchRoot(Bitboard* board, const int moves[], int moveCount, int draft, int alpha, int beta, SearchContext* search, int* bestCell) {
+    int bestScore = INT_MIN;
+    
+    for (int i = 0; i < moveCount; i++) {
+        int cell = moves[i];
+        int score;
+        
+        toggleCell(board, cell, 1);
+        if (completesLine(&board->x, cell)) {
+            score = WIN_SCORE;
+        } else if (i == 0) {
+            score = minimax(board, 0, draft - 1, 0, alpha, beta, search);
+        } else {
+            score = minimax(board, 0, draft - 1, 0, alpha, alpha + 1, search);
+            if (score > alpha && score < beta) {
+                score = minimax(board, 0, draft - 1, 0, alpha, beta, search);
             }
         }
+        toggleCell(board, cell, 1);
+        if (search->stopped) break;
+        
+        if (score > bestScore) {
+            bestScore = score;
+            *bestCell = cell;
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
     }
+    return bestScore;
 }
 
-void boardToString(int board[BOARD_SIZE][BOARD_SIZE], char* str) {
-    int index = 0;
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            str[index++] = '0' + (board[i][j] + 1);
+// Parallel Search
+// Root splitting: after the first (best-ordered) root move has been
+// searched alone to set a bound, threads claim the remaining root moves
+// one at a time and test them against the best score so far.
+typedef struct {
+    const Bitboard* board;
+    const int* moves;
+    int moveCount;
+    int draft;
+    int beta;
+    int nextMove;               // next root move to claim, taken atomically
+    int alpha;                  // best score so far, read atomically
+    int bestScore;
+    int bestCell;
+    pthread_mutex_t lock;
+} RootSplit;
+
+typedef struct {
+    RootSplit* split;
+    SearchContext* search;
+} RootSplitWorker;
+
+static void* rootSplitWorker(void* arg) {
+    RootSplitWorker* worker = (RootSplitWorker*)arg;
+    RootSplit* split = worker->split;
+    SearchContext* search = worker->search;
+    Bitboard board = *split->board;
+    
+    while (!search->stopped) {
+        int i = __atomic_fetch_add(&split->nextMove, 1, __ATOMIC_RELAXED);
+        if (i >= split->moveCount) break;
+        int alpha = __atomic_load_n(&split->alpha, __ATOMIC_RELAXED);
+        if (alpha >= split->beta) break;
+        
+        int cell = split->moves[i];
+        int score;
+        toggleCell(&board, cell, 1);
+        if (completesLine(&board.x, cell)) {
+            score = WIN_SCORE;
+        } else {
+            score = minimax(&board, 0, split->draft - 1, 0, alpha, alpha + 1, search);
+            if (score > alpha && score < split->beta) {
+                score = minimax(&board, 0, split->draft - 1, 0, alpha, split->beta, search);
+            }
+        }
+        toggleCell(&board, cell, 1);
+        if (search->stopped) break;
+        
+        pthread_mutex_lock(&split->lock);
+        if (score > split->bestScore) {
+            split->bestScore = score;
+            split->bestCell = cell;
         }
+        if (score > split->alpha) __atomic_store_n(&split->alpha, score, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&split->lock);
     }
-    str[index] = '\0';
+    return NULL;
 }
 
-int minimax(int board[BOARD_SIZE][BOARD_SIZE], int depth, int isMaximizing, int alpha, int beta, MemoTable* memo, int* nodesEvaluated) {
-    (*nodesEvaluated)++;
+// Parallel counterpart of searchRoot(); contexts[0] belongs to the calling
+// thread and is marked stopped if any thread ran out of time.
+static int searchRootSplit(Bitboard* board, const int moves[], int moveCount, int draft, int alpha, int beta, SearchContext* contexts, int threads, int* bestCell) {
+    int firstScore = searchRoot(board, moves, 1, draft, alpha, beta, &contexts[0], bestCell);
+    if (contexts[0].stopped || moveCount == 1 || firstScore >= beta) return firstScore;
     
-    char key[BOARD_SIZE * BOARD_SIZE + 1];
-    boardToString(board, key);
+    RootSplit split;
+    split.board = board;
+    split.moves = moves;
+    split.moveCount = moveCount;
+    split.draft = draft;
+    split.beta = beta;
+    split.nextMove = 1;
+    split.alpha = firstScore > alpha ? firstScore : alpha;
+    split.bestScore = firstScore;
+    split.bestCell = moves[0];
+    pthread_mutex_init(&split.lock, NULL);
     
-    int cachedMoveI, cachedMoveJ;
-    int cachedScore = memoLookup(memo, key, &cachedMoveI, &cachedMoveJ);
-    if (cachedScore != INT_MIN) {
-        return cachedScore;
+    pthread_t handles[MAX_SEARCH_THREADS];
+    RootSplitWorker workers[MAX_SEARCH_THREADS];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].split = &split;
+        workers[t].search = &contexts[t];
     }
-    
-    int winner = checkWinner(board);
-    if (winner != INT_MIN) {
-        if (winner == 1) return 10 - depth;
-        else if (winner == -1) return depth - 10;
-        else return 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, rootSplitWorker, &workers[t]) != 0) break;
+        started = t;
+    }
+    rootSplitWorker(&workers[0]);
+    for (int t = 1; t <= started; t++) {
+        pthread_join(handles[t], NULL);
+        if (contexts[t].stopped) contexts[0].stopped = 1;
     }
+    pthread_mutex_destroy(&split.lock);
     
-    Point moves[BOARD_SIZE * BOARD_SIZE];
+    *bestCell = split.bestCell;
+    return split.bestScore;
+}
+
+// One thread's iterative deepening loop; helpers in lazy SMP run their own.
+typedef struct {
+    Bitboard board;
+    SearchContext* search;
+    SearchContext* splitContexts;   // root split: one per thread, [0] == search
+    int splitThreads;               // 1 unless root splitting
+    int moves[MAX_BOARD_CELLS];
     int moveCount;
-    getAvailableMoves(board, moves, &moveCount);
+    int startDepth;
+    int maxDepth;
+    int bestCell;
+    int completedDepth;
+} DeepeningJob;
+
+// Iterative deepening: search one ply deeper each pass until the board is
+// exhausted, a forced result is proven, maxDepth is reached or the move
+// time budget runs out. Each pass after the first starts with an
+// aspiration window around the previous score and widens only the side
+// that fails. Only completed passes are trusted.
+static void iterativeDeepening(DeepeningJob* job) {
+    SearchContext* search = job->search;
+    int* moves = job->moves;
+    int bestScore = 0;
     
-    if (isMaximizing) {
-        int bestScore = INT_MIN;
-        int bestMoveI = -1, bestMoveJ = -1;
+    job->bestCell = moves[0];
+    job->completedDepth = 0;
+    
+    for (int depth = job->startDepth; depth <= job->maxDepth && job->moveCount > 1; depth++) {
+        int alpha = -WIN_SCORE - 1, beta = WIN_SCORE + 1;
+        if (depth > job->startDepth && bestScore > -WIN_THRESHOLD && bestScore < WIN_THRESHOLD) {
+            alpha = bestScore - ASPIRATION_WINDOW;
+            beta = bestScore + ASPIRATION_WINDOW;
+        }
         
-        for (int i = 0; i < moveCount; i++) {
-            int x = moves[i].x, y = moves[i].y;
-            board[x][y] = 1;
-            int score = minimax(board, depth + 1, 0, alpha, beta, memo, nodesEvaluated);
-            board[x][y] = 0;
-            
-            if (score > bestScore) {
-                bestScore = score;
-                bestMoveI = x;
-                bestMoveJ = y;
+        int iterationBest = moves[0];
+        int iterationScore;
+        while (1) {
+            if (job->splitThreads > 1) {
+                iterationScore = searchRootSplit(&job->board, moves, job->moveCount, depth, alpha, beta,
+                                                 job->splitContexts, job->splitThreads, &iterationBest);
+            } else {
+                iterationScore = searchRoot(&job->board, moves, job->moveCount, depth, alpha, beta, search, &iterationBest);
             }
-            
-            if (score > alpha) alpha = score;
-            if (beta <= alpha) break;
+            if (search->stopped) break;
+            if (iterationScore <= alpha) alpha = -WIN_SCORE - 1;
+            else if (iterationScore >= beta) beta = WIN_SCORE + 1;
+            else break;
         }
+        if (search->stopped) break;
         
-        memoInsert(memo, key, bestScore, bestMoveI, bestMoveJ);
-        return bestScore;
-    } else {
-        int bestScore = INT_MAX;
-        int bestMoveI = -1, bestMoveJ = -1;
+        job->bestCell = iterationBest;
+        job->completedDepth = depth;
+        bestScore = iterationScore;
+        if (bestScore >= WIN_THRESHOLD || bestScore <= -WIN_THRESHOLD) break;
         
-        for (int i = 0; i < moveCount; i++) {
-            int x = moves[i].x, y = moves[i].y;
-            board[x][y] = -1;
-            int score = minimax(board, depth + 1, 1, alpha, beta, memo, nodesEvaluated);
-            board[x][y] = 0;
-            
-            if (score < bestScore) {
-                bestScore = score;
-                bestMoveI = x;
-                bestMoveJ = y;
+        // Search the previous best move first on the next pass.
+        for (int i = 0; i < job->moveCount; i++) {
+            if (moves[i] == job->bestCell) {
+                moves[i] = moves[0];
+                moves[0] = job->bestCell;
+                break;
             }
-            
-            if (score < beta) beta = score;
-            if (beta <= alpha) break;
         }
+    }
+}
+
+static void* deepeningWorker(void* arg) {
+    iterativeDeepening((DeepeningJob*)arg);
+    return NULL;
+}
+
+static void initSearchContext(SearchContext* search, TranspositionTable* tt, long long deadline, int* sharedStop) {
+    memset(search, 0, sizeof(*search));
+    search->tt = tt;
+    search->deadline = deadline;
+    search->sharedStop = sharedStop;
+    for (int ply = 0; ply < MAX_SEARCH_PLY; ply++) {
+        search->killers[ply][0] = search->killers[ply][1] = -1;
+    }
+}
+
+static inline double ratio(long long part, long long whole) {
+    return whole > 0 ? (double)part / whole : 0;
+}
+
+// Sums a move's counters into a running total, e.g. for a whole game.
+void addSearchStats(SearchStats* total, const SearchStats* move) {
+    if (total->engine == 0) total->engine = move->engine;
+    if (move->threads > total->threads) total->threads = move->threads;
+    if (move->depth > total->depth) total->depth = move->depth;
+    total->nodes += move->nodes;
+    for (int ply = 0; ply < MAX_SEARCH_PLY; ply++) total->nodesAtPly[ply] += move->nodesAtPly[ply];
+    total->ttProbes += move->ttProbes;
+    total->ttHits += move->ttHits;
+    total->ttCollisions += move->ttCollisions;
+    total->cutoffs += move->cutoffs;
+    total->firstMoveCutoffs += move->firstMoveCutoffs;
+    total->expandedNodes += move->expandedNodes;
+    total->movesSearched += move->movesSearched;
+    total->elapsedNanos += move->elapsedNanos;
+}
+
+// Writes stats as one line of JSON. type names the record, e.g. "move"
+// with the ply the move was made at, or "game" with the game's length in
+// plies. Rates are fractions and nodesAtPly stops at the deepest ply reached.
+void writeSearchStatsJson(FILE* out, const char* type, int index, const SearchStats* stats) {
+    const char* engine = stats->engine == SEARCH_ALPHA_BETA ? "alpha-beta" :
+                         stats->engine == SEARCH_MCTS ? "mcts" : "none";
+    double seconds = stats->elapsedNanos / 1e9;
+    fprintf(out, "{\"type\":\"%s\",\"index\":%d,\"engine\":\"%s\",\"threads\":%d,\"depth\":%d,"
+                 "\"nodes\":%lld,\"seconds\":%.6f,\"nodesPerSecond\":%.0f,"
+                 "\"ttProbes\":%lld,\"ttHitRate\":%.4f,\"ttCollisionRate\":%.4f,"
+                 "\"cutoffs\":%lld,\"firstMoveCutoffRate\":%.4f,\"branchingFactor\":%.3f,\"nodesAtPly\":[",
+            type, index, engine, stats->threads, stats->depth,
+            stats->nodes, seconds, seconds > 0 ? stats->nodes / seconds : 0,
+            stats->ttProbes, ratio(stats->ttHits, stats->ttProbes), ratio(stats->ttCollisions, stats->ttProbes),
+            stats->cutoffs, ratio(stats->firstMoveCutoffs, stats->cutoffs), ratio(stats->movesSearched, stats->expandedNodes));
+    int plies = MAX_SEARCH_PLY;
+    while (plies > 0 && stats->nodesAtPly[plies - 1] == 0) plies--;
+    for (int ply = 0; ply < plies; ply++) {
+        fprintf(out, ply ? ",%lld" : "%lld", stats->nodesAtPly[ply]);
+    }
+    fprintf(out, "]}\n");
+}
+
+static void printSearchStats(const SearchStats* stats) {
+    double seconds = stats->elapsedNanos / 1e9;
+    printf("AI evaluated %lld nodes to depth %d in %.4f seconds (%.0f nodes/s)\n",
+           stats->nodes, stats->depth, seconds, seconds > 0 ? stats->nodes / seconds : 0);
+    printf("Table probes: %lld, %.1f%% hits, %.1f%% collisions\n",
+           stats->ttProbes, 100 * ratio(stats->ttHits, stats->ttProbes), 100 * ratio(stats->ttCollisions, stats->ttProbes));
+    printf("Cutoffs: %lld, %.1f%% on the first move; branching factor %.2f\n",
+           stats->cutoffs, 100 * ratio(stats->firstMoveCutoffs, stats->cutoffs), ratio(stats->movesSearched, stats->expandedNodes));
+}
+
+// Runs the configured search (serial, root split or lazy SMP) and fills
+// *stats. When verbose, also prints them with per-thread throughput and
+// the table fill.
+Point getAIMove(Bitboard* board, TranspositionTable* tt, SearchStats* stats) {
+    long long start = monotonicNanos();
+    long long deadline = start + (long long)engineConfig.moveTimeMs * 1000000LL;
+    int threads = engineConfig.threads < 1 ? 1 : engineConfig.threads;
+    if (threads > MAX_SEARCH_THREADS) threads = MAX_SEARCH_THREADS;
+    int lazySMP = threads > 1 && engineConfig.parallelMode == PARALLEL_LAZY_SMP;
+    int stop = 0;
+    tt->age++;
+    
+    SearchContext* contexts = (SearchContext*)malloc(threads * sizeof(SearchContext));
+    DeepeningJob* jobs = (DeepeningJob*)malloc((lazySMP ? threads : 1) * sizeof(DeepeningJob));
+    if (contexts == NULL || jobs == NULL) {
+        printf("Memory allocation failed for search threads!\n");
+        exit(1);
+    }
+    for (int t = 0; t < threads; t++) {
+        initSearchContext(&contexts[t], tt, deadline, lazySMP ? &stop : NULL);
+    }
+    
+    DeepeningJob* primary = &jobs[0];
+    BoardMask empty = emptySquares(board);
+    primary->board = *board;
+    primary->search = &contexts[0];
+    primary->splitContexts = contexts;
+    primary->splitThreads = lazySMP ? 1 : threads;
+    primary->moveCount = distinctMoves(board, empty, primary->moves);
+    orderMoves(board, primary->moves, primary->moveCount, -1, 0, 1, &contexts[0]);
+    primary->startDepth = 1;
+    primary->maxDepth = popCount(&empty);
+    if (engineConfig.maxDepth > 0 && engineConfig.maxDepth < primary->maxDepth) primary->maxDepth = engineConfig.maxDepth;
+    
+    pthread_t helpers[MAX_SEARCH_THREADS];
+    int helperCount = 0;
+    if (lazySMP && primary->moveCount > 1) {
+        // Helpers start at staggered depths with a rotated root order so
+        // they fill the shared table with different parts of the tree.
+        for (int t = 1; t < threads; t++) {
+            DeepeningJob* job = &jobs[t];
+            *job = *primary;
+            job->search = &contexts[t];
+            job->splitContexts = &contexts[t];
+            job->startDepth = 1 + (t & 1);
+            int swap = t % job->moveCount;
+            int first = job->moves[0];
+            job->moves[0] = job->moves[swap];
+            job->moves[swap] = first;
+            if (pthread_create(&helpers[t], NULL, deepeningWorker, job) != 0) break;
+            helperCount = t;
+        }
+    }
+    
+    iterativeDeepening(primary);
+    
+    int bestCell = primary->bestCell;
+    int completedDepth = primary->completedDepth;
+    if (lazySMP) {
+        __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+        for (int t = 1; t <= helperCount; t++) {
+            pthread_join(helpers[t], NULL);
+            // A helper that got further than the main thread has the better move.
+            if (jobs[t].completedDepth > completedDepth) {
+                completedDepth = jobs[t].completedDepth;
+                bestCell = jobs[t].bestCell;
+            }
+        }
+    }
+    
+    memset(stats, 0, sizeof(SearchStats));
+    for (int t = 0; t < threads; t++) addSearchStats(stats, &contexts[t].stats);
+    stats->engine = SEARCH_ALPHA_BETA;
+    stats->threads = threads;
+    stats->depth = completedDepth;
+    stats->elapsedNanos = monotonicNanos() - start;
+    double timeTaken = stats->elapsedNanos / 1e9;
+    
+    if (engineConfig.verbose) {
+        printSearchStats(stats);
+        if (threads > 1 && timeTaken > 0) {
+            printf("Search threads: %d (%s), per thread nodes/s:", threads, lazySMP ? "lazy SMP" : "root split");
+            for (int t = 0; t < threads; t++) printf(" %.0f", contexts[t].stats.nodes / timeTaken);
+            printf("\n");
+        }
+        printf("Transposition table: %d/%u entries used\n", tt->count, tt->size);
+    }
+    
+    free(contexts);
+    free(jobs);
+    
+    Point bestMove = {bestCell / engineConfig.size, bestCell % engineConfig.size};
+    return bestMove;
+}
+
+// Searches board to a fixed depth once with one thread and once with
+// threads in mode, each from an empty table, and prints the time-to-depth
+// speedup. Returns the speedup.
+double measureSearchSpeedup(const Bitboard* board, int threads, int mode, int depth) {
+    TicTacToeConfig saved = engineConfig;
+    TranspositionTable tt;
+    double seconds[2];
+    
+    initTranspositionTable(&tt, TT_SIZE_LOG2);
+    for (int run = 0; run < 2; run++) {
+        Bitboard copy = *board;
+        SearchStats stats;
+        engineConfig.maxDepth = depth;
+        engineConfig.moveTimeMs = INT_MAX / 2;
+        engineConfig.threads = run == 0 ? 1 : threads;
+        engineConfig.parallelMode = mode;
+        clearTranspositionTable(&tt);
         
-        memoInsert(memo, key, bestScore, bestMoveI, bestMoveJ);
-        return bestScore;
+        long long start = monotonicNanos();
+        getAIMove(&copy, &tt, &stats);
+        seconds[run] = (monotonicNanos() - start) / 1e9;
+    }
+    freeTranspositionTable(&tt);
+    engineConfig = saved;
+    
+    double speedup = seconds[1] > 0 ? seconds[0] / seconds[1] : 0;
+    printf("Depth %d: 1 thread %.4fs, %d threads %.4fs, speedup %.2fx\n",
+           depth, seconds[0], threads, seconds[1], speedup);
+    return speedup;
+}
+
+// Monte Carlo Tree Search
+// UCT over the same candidate moves as the alpha-beta search, with
+// uniformly random playouts on the raw bitboards. Threads share one tree;
+// a visit counts as a loss until its playout is backed up (virtual loss),
+// which steers concurrent threads down different lines.
+
+typedef struct {
+    MctsTree* tree;
+    const Bitboard* board;
+    Rng rng;
+    long long deadline;
+    int budget;                 // iterations for the whole search, 0 = until deadline
+    int* iterations;            // shared by all threads
+    int maxDepth;               // deepest path this thread walked
+} MctsJob;
+
+void freeMctsTree(MctsTree* tree) {
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->capacity = tree->used = 0;
+}
+
+// Grows the pool to at least nodes entries. Only called between searches,
+// never while threads hold indices into it.
+static void reserveMctsNodes(MctsTree* tree, int nodes) {
+    if (nodes > MCTS_POOL_NODES) nodes = MCTS_POOL_NODES;
+    if (nodes <= tree->capacity) return;
+    MctsNode* grown = (MctsNode*)realloc(tree->nodes, nodes * sizeof(MctsNode));
+    if (grown == NULL) {
+        printf("Memory allocation failed for MCTS tree!\n");
+        exit(1);
+    }
+    tree->nodes = grown;
+    tree->capacity = nodes;
+}
+
+// Claims a pool slot; returns -1 once the pool is full.
+static inline int newMctsNode(MctsTree* tree, int move) {
+    int index = __atomic_fetch_add(&tree->used, 1, __ATOMIC_RELAXED);
+    if (index >= tree->capacity) return -1;
+    MctsNode* node = &tree->nodes[index];
+    node->firstChild = -1;
+    node->nextSibling = -1;
+    node->move = move;
+    node->expanded = 0;
+    node->visits = 0;
+    node->score = 0;
+    return index;
+}
+
+static void resetMctsTree(MctsTree* tree, const Bitboard* board) {
+    tree->used = 0;
+    tree->root = newMctsNode(tree, -1);
+    tree->rootBoard = *board;
+}
+
+static int findMctsChild(const MctsTree* tree, int node, int move) {
+    for (int child = tree->nodes[node].firstChild; child != -1; child = tree->nodes[child].nextSibling) {
+        if (tree->nodes[child].move == move) return child;
+    }
+    return -1;
+}
+
+// Moves the root to board if it is the old root plus one X and one O
+// stone that the tree already contains; otherwise starts a fresh tree.
+static int advanceMctsTree(MctsTree* tree, const Bitboard* board) {
+    if (tree->used > 0 && tree->used <= tree->capacity * 3 / 4) {
+        BoardMask newX = maskAnd(board->x, tree->rootBoard.x);
+        BoardMask newO = maskAnd(board->o, tree->rootBoard.o);
+        int xCell, oCell, reused = -1;
+        if (memcmp(&newX, &tree->rootBoard.x, sizeof(BoardMask)) == 0 &&
+            memcmp(&newO, &tree->rootBoard.o, sizeof(BoardMask)) == 0 &&
+            popCount(&board->x) == popCount(&tree->rootBoard.x) + 1 &&
+            popCount(&board->o) == popCount(&tree->rootBoard.o) + 1) {
+            for (int w = 0; w < BOARD_WORDS; w++) {
+                newX.w[w] = board->x.w[w] & ~tree->rootBoard.x.w[w];
+                newO.w[w] = board->o.w[w] & ~tree->rootBoard.o.w[w];
+            }
+            maskToCells(&newX, &xCell);
+            maskToCells(&newO, &oCell);
+            int child = findMctsChild(tree, tree->root, xCell);
+            if (child != -1) reused = findMctsChild(tree, child, oCell);
+        }
+        if (reused != -1) {
+            tree->root = reused;
+            tree->rootBoard = *board;
+            return tree->nodes[reused].visits;
+        }
+    }
+    resetMctsTree(tree, board);
+    return 0;
+}
+
+// Random game from the position to the end; returns the winner (1 = X,
+// -1 = O) or 0 for a draw.
+static int randomPlayout(BoardMask x, BoardMask o, int player, Rng* rng) {
+    Bitboard position = {x, o, {0}};
+    BoardMask empty = emptySquares(&position);
+    int cells[MAX_BOARD_CELLS];
+    int count = maskToCells(&empty, cells);
+    while (count > 0) {
+        int i = rngBelow(rng, count);
+        int cell = cells[i];
+        cells[i] = cells[--count];
+        BoardMask* side = player == 1 ? &x : &o;
+        maskSet(side, cell);
+        if (completesLine(side, cell)) return player;
+        player = -player;
+    }
+    return 0;
+}
+
+// UCT choice among node's children; -1 if it has none.
+static int selectMctsChild(MctsTree* tree, int node) {
+    int parentVisits = __atomic_load_n(&tree->nodes[node].visits, __ATOMIC_RELAXED);
+    double logVisits = log(parentVisits > 1 ? parentVisits : 1);
+    int best = -1;
+    double bestValue = -1;
+    int child = __atomic_load_n(&tree->nodes[node].firstChild, __ATOMIC_ACQUIRE);
+    for (; child != -1; child = tree->nodes[child].nextSibling) {
+        int visits = __atomic_load_n(&tree->nodes[child].visits, __ATOMIC_RELAXED);
+        if (visits == 0) return child;
+        int score = __atomic_load_n(&tree->nodes[child].score, __ATOMIC_RELAXED);
+        double value = score / (2.0 * visits) + MCTS_EXPLORATION * sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = child;
+        }
     }
+    return best;
 }
 
-Point getAIMove(int board[BOARD_SIZE][BOARD_SIZE], MemoTable* memo, int* nodesEvaluated) {
-    *nodesEvaluated = 0;
-    clock_t start = clock();
+// One selection, expansion, playout and backup pass; returns the length
+// of the tree path it walked.
+static int mctsIteration(MctsTree* tree, const Bitboard* rootBoard, Rng* rng) {
+    // Only the stone masks are updated below; the keys are not needed.
+    Bitboard board = *rootBoard;
+    int path[MAX_SEARCH_PLY + 1];
+    int length = 0;
+    int node = tree->root;
+    int player = 1;
+    int winner = 0;
     
-    Point bestMove = {-1, -1};
-    int bestScore = INT_MIN;
+    path[length++] = node;
+    __atomic_fetch_add(&tree->nodes[node].visits, 1, __ATOMIC_RELAXED);
+    while (1) {
+        BoardMask candidates = candidateSquares(&board, emptySquares(&board));
+        int moves[MAX_BOARD_CELLS];
+        int moveCount = maskToCells(&candidates, moves);
+        if (moveCount == 0) break;  // full board: draw
+        
+        MctsNode* current = &tree->nodes[node];
+        int child = -1, created = 0;
+        if (__atomic_load_n(&current->expanded, __ATOMIC_RELAXED) < moveCount) {
+            int k = __atomic_fetch_add(&current->expanded, 1, __ATOMIC_RELAXED);
+            if (k < moveCount) child = newMctsNode(tree, moves[k]);
+            if (child != -1) {
+                created = 1;
+                int head = __atomic_load_n(&current->firstChild, __ATOMIC_RELAXED);
+                do {
+                    tree->nodes[child].nextSibling = head;
+                } while (!__atomic_compare_exchange_n(&current->firstChild, &head, child, 1,
+                                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+            }
+        }
+        if (child == -1) child = selectMctsChild(tree, node);
+        if (child == -1) {
+            // Pool exhausted before this node got children.
+            winner = randomPlayout(board.x, board.o, player, rng);
+            break;
+        }
+        
+        int cell = tree->nodes[child].move;
+        BoardMask* side = player == 1 ? &board.x : &board.o;
+        maskSet(side, cell);
+        path[length++] = child;
+        __atomic_fetch_add(&tree->nodes[child].visits, 1, __ATOMIC_RELAXED);
+        if (completesLine(side, cell)) {
+            winner = player;
+            break;
+        }
+        player = -player;
+        if (created) {
+            winner = randomPlayout(board.x, board.o, player, rng);
+            break;
+        }
+        node = child;
+    }
     
-    Point moves[BOARD_SIZE * BOARD_SIZE];
-    int moveCount;
-    getAvailableMoves(board, moves, &moveCount);
+    // path[i] was entered by X for odd i and by O for even i.
+    for (int i = 1; i < length; i++) {
+        int mover = (i & 1) ? 1 : -1;
+        int reward = winner == mover ? 2 : (winner == 0 ? 1 : 0);
+        if (reward) __atomic_fetch_add(&tree->nodes[path[i]].score, reward, __ATOMIC_RELAXED);
+    }
+    return length - 1;
+}
+
+static void* mctsWorker(void* arg) {
+    MctsJob* job = (MctsJob*)arg;
+    for (int done = 0; ; done++) {
+        int started = __atomic_fetch_add(job->iterations, 1, __ATOMIC_RELAXED);
+        if (job->budget > 0 && started >= job->budget) break;
+        if ((done & 63) == 0 && monotonicNanos() >= job->deadline) break;
+        int depth = mctsIteration(job->tree, job->board, &job->rng);
+        if (depth > job->maxDepth) job->maxDepth = depth;
+    }
+    return NULL;
+}
+
+// Best move for X by MCTS within the configured move time and, if
+// iterations > 0, that many playouts. Reuses the subtree from the last
+// call when the game has followed it. Fills *stats.
+static Point getMCTSMove(Bitboard* board, MctsTree* tree, int iterations, SearchStats* stats, Rng* rng) {
+    long long start = monotonicNanos();
+    int threads = engineConfig.threads < 1 ? 1 : engineConfig.threads;
+    if (threads > MAX_SEARCH_THREADS) threads = MAX_SEARCH_THREADS;
     
-    if (moveCount == 1) {
-        bestMove = moves[0];
+    reserveMctsNodes(tree, iterations > 0 ? tree->used + iterations + 1 : MCTS_POOL_NODES);
+    int reused = advanceMctsTree(tree, board);
+    
+    int started = 0;
+    MctsJob jobs[MAX_SEARCH_THREADS];
+    pthread_t helpers[MAX_SEARCH_THREADS];
+    int helperCount = 0;
+    for (int t = 0; t < threads; t++) {
+        jobs[t].tree = tree;
+        jobs[t].board = &tree->rootBoard;
+        rngSeed(&jobs[t].rng, rngNext(rng));
+        jobs[t].deadline = start + (long long)engineConfig.moveTimeMs * 1000000LL;
+        jobs[t].budget = iterations;
+        jobs[t].iterations = &started;
+        jobs[t].maxDepth = 0;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&helpers[t], NULL, mctsWorker, &jobs[t]) != 0) break;
+        helperCount = t;
+    }
+    mctsWorker(&jobs[0]);
+    for (int t = 1; t <= helperCount; t++) pthread_join(helpers[t], NULL);
+    if (tree->used > tree->capacity) tree->used = tree->capacity;
+    
+    // The most visited move is the most reliable one.
+    int best = -1, bestVisits = -1;
+    for (int child = tree->nodes[tree->root].firstChild; child != -1; child = tree->nodes[child].nextSibling) {
+        if (tree->nodes[child].visits > bestVisits) {
+            bestVisits = tree->nodes[child].visits;
+            best = child;
+        }
+    }
+    int bestCell;
+    if (best != -1) {
+        bestCell = tree->nodes[best].move;
     } else {
-        for (int i = 0; i < moveCount; i++) {
-            int x = moves[i].x, y = moves[i].y;
-            board[x][y] = 1;
-            int score = minimax(board, 0, 0, INT_MIN, INT_MAX, memo, nodesEvaluated);
-            board[x][y] = 0;
+        BoardMask candidates = candidateSquares(board, emptySquares(board));
+        int moves[MAX_BOARD_CELLS];
+        maskToCells(&candidates, moves);
+        bestCell = moves[0];
+    }
+    
+    memset(stats, 0, sizeof(SearchStats));
+    stats->engine = SEARCH_MCTS;
+    stats->threads = threads;
+    stats->nodes = tree->nodes[tree->root].visits - reused;
+    for (int t = 0; t < threads; t++) {
+        if (jobs[t].maxDepth > stats->depth) stats->depth = jobs[t].maxDepth;
+    }
+    stats->elapsedNanos = monotonicNanos() - start;
+    if (engineConfig.verbose) {
+        printf("MCTS ran %lld playouts, %d plies deep, in %.4f seconds (%d threads, %d reused)\n",
+               stats->nodes, stats->depth, stats->elapsedNanos / 1e9, threads, reused);
+        printf("Search tree: %d/%d nodes used\n", tree->used, tree->capacity);
+    }
+    
+    Point bestMove = {bestCell / engineConfig.size, bestCell % engineConfig.size};
+    return bestMove;
+}
+
+// Perfect-Play Table
+// Every 3x3 position is solved once and kept in a file that later runs
+// map read-only, so a HARD move is a single indexed load.
+#define PERFECT_UNSOLVED -128
+
+static const char perfectTableMagic[8] = "TTTPPT1";
+static unsigned short base3Digits[1 << 9];
+static const PerfectEntry* perfectTable = NULL;
+
+static inline int perfectIndex(const Bitboard* board, int isMaximizing) {
+    return (base3Digits[board->x.w[0] & 0x1FF] + 2 * base3Digits[board->o.w[0] & 0x1FF]) * 2 + !isMaximizing;
+}
+
+static unsigned int perfectChecksum(const PerfectEntry* table) {
+    const unsigned char* bytes = (const unsigned char*)table;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < PERFECT_TABLE_STATES * 2 * sizeof(PerfectEntry); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static int solvePosition(PerfectEntry* table, Bitboard* board, int isMaximizing) {
+    PerfectEntry* entry = &table[perfectIndex(board, isMaximizing)];
+    if (entry->value != PERFECT_UNSOLVED) return entry->value;
+    
+    int value;
+    int bestCell = -1;
+    BoardMask empty = emptySquares(board);
+    
+    if (hasWinningLine(&board->x)) value = 10;
+    else if (hasWinningLine(&board->o)) value = -10;
+    else if (maskIsEmpty(&empty)) value = 0;
+    else {
+        int cells[9];
+        int count = maskToCells(&empty, cells);
+        BoardMask* side = isMaximizing ? &board->x : &board->o;
+        
+        value = isMaximizing ? INT_MIN : INT_MAX;
+        for (int i = 0; i < count; i++) {
+            maskFlip(side, cells[i]);
+            int score = solvePosition(table, board, !isMaximizing);
+            maskFlip(side, cells[i]);
             
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = moves[i];
+            // Ties go to the lowest cell.
+            if (isMaximizing ? score > value : score < value) {
+                value = score;
+                bestCell = cells[i];
             }
         }
+        // One ply further from the end than the best reply.
+        if (value > 0) value--;
+        else if (value < 0) value++;
     }
     
-    clock_t end = clock();
-    double timeTaken = ((double)(end - start)) / CLOCKS_PER_SEC;
+    entry->value = (signed char)value;
+    entry->bestMove = (signed char)bestCell;
+    return value;
+}
+
+static void buildPerfectTable(PerfectEntry* table) {
+    for (int i = 0; i < PERFECT_TABLE_STATES * 2; i++) {
+        table[i].value = PERFECT_UNSOLVED;
+        table[i].bestMove = -1;
+    }
     
-    printf("AI evaluated %d nodes in %.4f seconds\n", *nodesEvaluated, timeTaken);
-    printf("Memoization cache size: %d\n", memo->count);
+    Bitboard board;
+    memset(&board, 0, sizeof(board));
+    solvePosition(table, &board, 1);
+    solvePosition(table, &board, 0);
     
-    return bestMove;
+    // Positions no game can reach stay in the file as empty entries.
+    for (int i = 0; i < PERFECT_TABLE_STATES * 2; i++) {
+        if (table[i].value == PERFECT_UNSOLVED) table[i].value = 0;
+    }
+}
+
+static int writePerfectTable(const char* path, const PerfectEntry* table) {
+    PerfectTableHeader header;
+    memcpy(header.magic, perfectTableMagic, sizeof(header.magic));
+    header.boardSize = 3;
+    header.states = PERFECT_TABLE_STATES;
+    header.checksum = perfectChecksum(table);
+    
+    FilePart parts[] = {
+        {&header, sizeof(header)},
+        {table, PERFECT_TABLE_STATES * 2 * sizeof(PerfectEntry)},
+    };
+    return writeFileAtomically(path, parts, 2);
+}
+
+static const PerfectEntry* mapPerfectTable(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    
+    struct stat st;
+    size_t expected = sizeof(PerfectTableHeader) + PERFECT_TABLE_STATES * 2 * sizeof(PerfectEntry);
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != expected) {
+        close(fd);
+        return NULL;
+    }
+    
+    void* mapped = mmap(NULL, expected, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return NULL;
+    
+    const PerfectTableHeader* header = (const PerfectTableHeader*)mapped;
+    const PerfectEntry* table = (const PerfectEntry*)(header + 1);
+    if (memcmp(header->magic, perfectTableMagic, sizeof(header->magic)) != 0 ||
+        header->boardSize != 3 || header->states != PERFECT_TABLE_STATES ||
+        header->checksum != perfectChecksum(table)) {
+        munmap(mapped, expected);
+        return NULL;
+    }
+    return table;
+}
+
+// Expects the engine to be configured for 3x3, three in a row.
+static void loadPerfectPlayTable(const char* path) {
+    if (perfectTable != NULL) return;
+    
+    for (int mask = 0; mask < (1 << 9); mask++) {
+        int digits = 0;
+        for (int cell = 8; cell >= 0; cell--) {
+            digits = digits * 3 + ((mask >> cell) & 1);
+        }
+        base3Digits[mask] = (unsigned short)digits;
+    }
+    
+    perfectTable = mapPerfectTable(path);
+    if (perfectTable != NULL) return;
+    
+    // First run, or a stale/corrupt file: solve, persist, then map.
+    PerfectEntry* table = (PerfectEntry*)malloc(PERFECT_TABLE_STATES * 2 * sizeof(PerfectEntry));
+    if (table == NULL) return;
+    buildPerfectTable(table);
+    
+    if (writePerfectTable(path, table)) {
+        perfectTable = mapPerfectTable(path);
+    }
+    if (perfectTable != NULL) {
+        free(table);
+    } else {
+        perfectTable = table;   // read-only directory: keep the in-memory copy
+    }
+}
+
+// True when Hard plays from the perfect-play table: classic 3x3 with the
+// table loaded.
+static int perfectPlayActive() {
+    return perfectTable != NULL && engineConfig.size == 3 && engineConfig.winLength == 3;
+}
+
+// Fills *move from the perfect-play table; returns 0 if it has no answer
+// (no table, or the engine is not playing classic 3x3).
+int getPerfectMove(const Bitboard* board, int isMaximizing, Point* move) {
+    if (!perfectPlayActive()) return 0;
+    int cell = perfectTable[perfectIndex(board, isMaximizing)].bestMove;
+    if (cell < 0) return 0;
+    move->x = cell / 3;
+    move->y = cell % 3;
+    return 1;
 }
 
-Point getAIMoveWithDifficulty(int board[BOARD_SIZE][BOARD_SIZE], MemoTable* memo, int* nodesEvaluated, int difficulty) {
-    Point moves[BOARD_SIZE * BOARD_SIZE];
+// Best move for X: a table load when available, otherwise a search with
+// the configured engine.
+static Point getBestMove(Bitboard* board, TranspositionTable* tt, MctsTree* mcts, SearchStats* stats, Rng* rng) {
+    Point move;
+    if (getPerfectMove(board, 1, &move)) return move;
+    if (engineConfig.searchEngine == SEARCH_MCTS) {
+        return getMCTSMove(board, mcts, 0, stats, rng);
+    }
+    if (tt->slots == NULL) initTranspositionTable(tt, TT_SIZE_LOG2);
+    return getAIMove(board, tt, stats);
+}
+
+// Move for X at the given difficulty. Easy and Medium run a short MCTS
+// whose iteration budget sets their strength; Hard plays its best.
+Point getAIMoveWithDifficulty(Bitboard* board, TranspositionTable* tt, MctsTree* mcts, SearchStats* stats, int difficulty, Rng* rng) {
+    Point moves[MAX_BOARD_CELLS];
     int moveCount;
     getAvailableMoves(board, moves, &moveCount);
+    memset(stats, 0, sizeof(SearchStats));
     
     if (moveCount == 1) {
         return moves[0];
     }
     
-    srand(time(NULL));
-    
     switch (difficulty) {
-        case 1: { // EASY: Mostly random moves
-            if (rand() % 100 < 20) { // 20% chance to make a smart move
-                return getAIMove(board, memo, nodesEvaluated);
-            } else {
-                return moves[rand() % moveCount];
-            }
-        }
+        case 1: // EASY: A handful of random playouts
+            return getMCTSMove(board, mcts, MCTS_EASY_ITERATIONS, stats, rng);
         
-        case 2: { // MEDIUM: Mix of random and smart moves
-            if (rand() % 100 < 60) { // 60% chance to make a smart move
-                return getAIMove(board, memo, nodesEvaluated);
-            } else {
-                return moves[rand() % moveCount];
-            }
-        }
+        case 2: // MEDIUM: Enough playouts to spot most threats
+            return getMCTSMove(board, mcts, MCTS_MEDIUM_ITERATIONS, stats, rng);
         
-        case 3: { // HARD: Always optimal
-            return getAIMove(board, memo, nodesEvaluated);
-        }
+        case 3: // HARD: Always optimal
+            return getBestMove(board, tt, mcts, stats, rng);
         
         default:
-            return getAIMove(board, memo, nodesEvaluated);
+            return getBestMove(board, tt, mcts, stats, rng);
     }
 }
 
 // Main Tic-Tac-Toe Game Function
 void playTicTacToeWithLevels() {
-    int board[BOARD_SIZE][BOARD_SIZE] = {{0}};
+    Bitboard board;
+    memset(&board, 0, sizeof(board));
     int currentPlayer = 1;
-    MemoTable memo;
-    initMemoTable(&memo, MEMO_TABLE_SIZE);
+    // Shared by every game; only allocated if a move ever needs a search.
+    static TranspositionTable tt;
+    static MctsTree mcts;
+    initTicTacToeEngine();
     
     printf("\n=== TIC-TAC-TOE WITH DIFFICULTY LEVELS ===\n");
+    TicTacToeConfig config;
+    config.size = getIntegerInput("Enter board size (3-15): ", 3, MAX_BOARD_SIZE);
+    char prompt[64];
+    snprintf(prompt, sizeof(prompt), "Enter stones in a row to win (3-%d): ", config.size);
+    config.winLength = getIntegerInput(prompt, 3, config.size);
+    config.moveTimeMs = DEFAULT_MOVE_TIME_MS;
+    config.maxDepth = 0;
+    config.threads = 1;
+    config.parallelMode = PARALLEL_LAZY_SMP;
+    config.verbose = 1;
+    config.searchEngine = SEARCH_ALPHA_BETA;
+    if (config.size > 3) {
+        snprintf(prompt, sizeof(prompt), "Enter AI search threads (1-%d): ", MAX_SEARCH_THREADS);
+        config.threads = getIntegerInput(prompt, 1, MAX_SEARCH_THREADS);
+        printf("Hard AI engine:\n");
+        printf("1. Alpha-beta (Exhaustive to the depth it reaches)\n");
+        printf("2. Monte Carlo tree search (Steadier on big boards)\n");
+        config.searchEngine = getIntegerInput("Enter engine (1-2): ", 1, 2) == 1 ? SEARCH_ALPHA_BETA : SEARCH_MCTS;
+    }
+    configureTicTacToe(&config);
+    clearTranspositionTable(&tt);
+    mcts.used = 0;              // a tree from another game must not be reused
+    
     printf("Choose difficulty level:\n");
-    printf("1. Easy (Mostly random moves)\n");
-    printf("2. Medium (Mix of random and smart)\n");
-    printf("3. Hard (Perfect AI - Unbeatable)\n");
+    printf("1. Easy (Short Monte Carlo search)\n");
+    printf("2. Medium (Longer Monte Carlo search)\n");
+    if (perfectPlayActive()) printf("3. Hard (Perfect AI - Unbeatable)\n");
+    else if (config.searchEngine == SEARCH_MCTS) printf("3. Hard (Timed Monte Carlo tree search)\n");
+    else printf("3. Hard (Timed alpha-beta search)\n");
     
     int difficulty = getIntegerInput("Enter difficulty (1-3): ", 1, 3);
     
     char* difficultyNames[] = {"Easy", "Medium", "Hard"};
-    printf("\nStarting game with %s difficulty!\n", difficultyNames[difficulty - 1]);
+    printf("\nStarting %dx%d game (%d in a row) with %s difficulty!\n",
+           config.size, config.size, config.winLength, difficultyNames[difficulty - 1]);
     printf("AI: X, You: O\n");
     
     printf("\nWho starts first?\n");
@@ -290,10 +1656,24 @@ void playTicTacToeWithLevels() {
     printf("2. You\n");
     int startFirst = getIntegerInput("Enter choice (1-2): ", 1, 2);
     currentPlayer = (startFirst == 1) ? 1 : -1;
+    Rng rng;
+    rngSeed(&rng, (unsigned long long)time(NULL));
+    
+    FILE* statsFile = NULL;
+    printf("\nSave AI search statistics to %s?\n", SEARCH_STATS_FILE);
+    printf("1. Yes\n");
+    printf("2. No\n");
+    if (getIntegerInput("Enter choice (1-2): ", 1, 2) == 1) {
+        statsFile = fopen(SEARCH_STATS_FILE, "a");
+        if (statsFile == NULL) printf("Could not open %s; statistics will not be saved.\n", SEARCH_STATS_FILE);
+    }
+    SearchStats gameStats;
+    memset(&gameStats, 0, sizeof(gameStats));
+    int ply = 0;
     
     while (1) {
-        printBoard(board);
-        int winner = checkWinner(board);
+        printBoard(&board);
+        int winner = checkWinner(&board);
         
         if (winner != INT_MIN) {
             if (winner == 1) printf("AI wins!\n");
@@ -302,20 +1682,23 @@ void playTicTacToeWithLevels() {
             break;
         }
         
+        ply++;
         if (currentPlayer == 1) {
             printf("AI is thinking...\n");
-            int nodesEvaluated;
-            Point move = getAIMoveWithDifficulty(board, &memo, &nodesEvaluated, difficulty);
-            board[move.x][move.y] = 1;
+            SearchStats stats;
+            Point move = getAIMoveWithDifficulty(&board, &tt, &mcts, &stats, difficulty, &rng);
+            addSearchStats(&gameStats, &stats);
+            if (statsFile != NULL) writeSearchStatsJson(statsFile, "move", ply, &stats);
+            setCell(&board, move.x, move.y, 1);
             printf("AI plays at position (%d, %d)\n", move.x, move.y);
             currentPlayer = -1;
         } else {
             while (1) {
-                printf("Enter your move (row column, 0-2 for both): ");
+                printf("Enter your move (row column, 0-%d for both): ", config.size - 1);
                 int row, col;
                 if (scanf("%d %d", &row, &col) == 2) {
-                    if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE && board[row][col] == 0) {
-                        board[row][col] = -1;
+                    if (row >= 0 && row < config.size && col >= 0 && col < config.size && getCell(&board, row, col) == 0) {
+                        setCell(&board, row, col, -1);
                         break;
                     } else {
                         printf("Invalid move! Try again.\n");
@@ -327,16 +1710,9 @@ void playTicTacToeWithLevels() {
             }
             currentPlayer = 1;
         }
+    }    
+    if (statsFile != NULL) {
+        writeSearchStatsJson(statsFile, "game", ply, &gameStats);
+        fclose(statsFile);
     }
-    
-    // Free memory
-    for (int i = 0; i < memo.size; i++) {
-        MemoEntry* entry = memo.table[i];
-        while (entry != NULL) {
-            MemoEntry* temp = entry;
-            entry = entry->next;
-            free(temp);
-        }
-    }
-    free(memo.table);
 }
\ No newline at end of file
@@ -33,4 +33,88 @@ float getFloatInput(const char* prompt, float min, float max) {
         printf("Invalid input! Please enter a number between %.1f and %.1f.\n", min, max);
         clearInputBuffer();
     }
+}
+
+// Reads one line into buffer without its newline; the rest of a line too
+// long for buffer is discarded.
+void getLineInput(const char* prompt, char* buffer, int size) {
+    printf("%s", prompt);
+    if (fgets(buffer, size, stdin) == NULL) {
+        buffer[0] = '\0';
+        return;
+    }
+    size_t length = strcspn(buffer, "\n");
+    if (buffer[length] == '\n') buffer[length] = '\0';
+    else if (!feof(stdin)) clearInputBuffer();
+}
+
+// Nanoseconds from a monotonic clock; only differences are meaningful.
+long long monotonicNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Writes the parts to path.tmp and renames it over path only once every
+// byte is on disk, so a reader (or a mapping) never sees a half-written
+// file and a failed write leaves any old file in place. Returns 0 on
+// failure.
+int writeFileAtomically(const char* path, const FilePart parts[], int count) {
+    size_t length = strlen(path);
+    char* tmpPath = (char*)malloc(length + 5);
+    if (tmpPath == NULL) {
+        printf("Memory allocation failed for file name!\n");
+        exit(1);
+    }
+    memcpy(tmpPath, path, length);
+    memcpy(tmpPath + length, ".tmp", 5);
+    
+    FILE* file = fopen(tmpPath, "wb");
+    int ok = file != NULL;
+    for (int i = 0; i < count && ok; i++) {
+        ok = parts[i].bytes == 0 || fwrite(parts[i].data, 1, parts[i].bytes, file) == parts[i].bytes;
+    }
+    if (file != NULL) ok = (fclose(file) == 0) && ok;
+    if (file != NULL && (!ok || rename(tmpPath, path) != 0)) {
+        remove(tmpPath);
+        ok = 0;
+    }
+    free(tmpPath);
+    return ok;
+}
+
+// Seeds all four state words through splitmix64, so nearby seeds (thread
+// ids, game numbers) still give unrelated streams.
+void rngSeed(Rng* rng, unsigned long long seed) {
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+static inline unsigned long long rotateLeft(unsigned long long x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// xoshiro256**: 64 random bits per call, no locks, no libc state.
+unsigned long long rngNext(Rng* rng) {
+    unsigned long long* s = rng->s;
+    unsigned long long result = rotateLeft(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotateLeft(s[3], 45);
+    return result;
+}
+
+// Uniform integer in [0, bound) by multiply-shift of the high 32 bits,
+// which is cheaper than a modulo and unbiased enough for small bounds.
+int rngBelow(Rng* rng, int bound) {
+    return (int)(((rngNext(rng) >> 32) * (unsigned long long)bound) >> 32);
 }
\ No newline at end of file